@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -6,6 +7,11 @@
 #include "esp_adc/adc_oneshot.h"
 #include "driver/gptimer.h"
 #include "max7219.h"
+#include "max7219_governor.h"
+#include "max7219_idle.h"
+#if CONFIG_PM_ENABLE
+#include "esp_pm.h"
+#endif
 
 static const char *TAG = "MAX7219_DEMO";
 
@@ -21,9 +27,25 @@ int light2pwm(adc_oneshot_unit_handle_t);
 #define PIN_PHOTORESISTOR  GPIO_NUM_5  // ADC input for ambient light sensor
 #define ADC_CHANNEL ADC_CHANNEL_5      // GPIO5 = ADC1 channel 5 on ESP32-C6
 
-// Scroll speed (lower = faster)
+// Scroll speed (lower = faster): one column per SCROLL_DELAY_MS
 #define SCROLL_DELAY_MS 200
 
+// Frame-rate governor bounds for the scrolling task. Periods up to
+// SCROLL_MAX_STEP * SCROLL_DELAY_MS keep the scroll speed by stepping more
+// columns; beyond that, up to SCROLL_MAX_PERIOD_MS, the scroll slows down.
+#define SCROLL_MIN_PERIOD_MS    SCROLL_DELAY_MS
+#define SCROLL_MAX_PERIOD_MS    (5 * SCROLL_DELAY_MS)
+#define SCROLL_MAX_STEP         3
+#define SPI_CLOCK_MIN_HZ        (1 * 1000 * 1000)
+#define SPI_CLOCK_MAX_HZ        (10 * 1000 * 1000)  // MAX7219 limit
+#define CPU_TARGET_PCT          50
+#define BUS_TARGET_PCT          50
+
+// Idle manager: wake-up backoff for the fixed display
+#define IDLE_MIN_DELAY_MS       200
+#define IDLE_MAX_DELAY_MS       3200
+#define IDLE_STATS_EVERY        64      // Log counters every N wake-ups
+
 // Message to display
 static const char *MESSAGE = "Hello from Claude!   ";
 
@@ -68,11 +90,43 @@ static inline void pwm_set_brightness(uint8_t brightness_percent)
     pwm_off_time_us = off_time;
 }
 
+// Set brightness, pausing the PWM timer while it would only keep the display
+// on (100%) so the ISR stops waking the CPU. The timer is disabled as well as
+// stopped, since only gptimer_disable() releases its PM lock.
+static bool pwm_running = true;
+
+static void pwm_update(max7219_t *display, uint8_t brightness_percent)
+{
+    pwm_set_brightness(brightness_percent);
+
+    if (brightness_percent >= 100 && pwm_running) {
+        gptimer_stop(pwm_timer);
+        gptimer_disable(pwm_timer);
+        pwm_running = false;
+        pwm_state = PWM_STATE_ON;
+        max7219_set_enabled(display, true);
+    } else if (brightness_percent < 100 && !pwm_running) {
+        // Timer is not auto-reloading, so re-arm relative to where it stopped
+        gptimer_enable(pwm_timer);
+        uint64_t count = 0;
+        gptimer_get_raw_count(pwm_timer, &count);
+        gptimer_alarm_config_t alarm_cfg = {
+            .alarm_count = count + pwm_on_time_us,
+            .flags.auto_reload_on_alarm = false,
+        };
+        gptimer_set_alarm_action(pwm_timer, &alarm_cfg);
+        pwm_state = PWM_STATE_ON;
+        gptimer_start(pwm_timer);
+        pwm_running = true;
+    }
+}
+
 // Brightness tuning parameters
 #define BRIGHTNESS_MIN      5    // Minimum brightness % (dark room)
 #define BRIGHTNESS_MAX      100  // Maximum brightness % (bright room)
 #define ADC_BRIGHT_LIMIT    100  // ADC reading in bright ambient light
 #define ADC_DARK_LIMIT      3500 // ADC reading in dark ambient light
+#define BRIGHTNESS_DEADBAND 2    // Changes smaller than this (%) count as constant, except at 100%
 
 // Display task parameters
 typedef struct {
@@ -181,17 +235,44 @@ static void max7219_fixed_task(void *pvParameters)
     const char *message = params->message;
     adc_oneshot_unit_handle_t adc_handle = params->adc_handle;
 
+    // Static: the idle manager holds a batch buffer too big for this stack
+    static max7219_idle_t idle;
+    max7219_idle_config_t idle_config = {
+        .min_delay_ms = IDLE_MIN_DELAY_MS,
+        .max_delay_ms = IDLE_MAX_DELAY_MS,
+        .shutdown_blank = true,
+        .reduce_scan_limit = false,  // Would brighten short content, see max7219_idle.h
+    };
+    max7219_idle_init(&idle, &idle_config);
+
     // Draw message once (static display)
     max7219_draw_string(display, 1, message);
-    max7219_refresh(display);
+    int last_brightness = -1;
 
     while (1) {
         // Update brightness from ambient light sensor
-        uint8_t brightness = light2pwm(adc_handle);
-        pwm_set_brightness(brightness);
-        ESP_LOGI(TAG, "brightness set to: %d",brightness);
-        // Sleep before next brightness update (100ms = 10 updates/sec is plenty)
-        vTaskDelay(pdMS_TO_TICKS(200));
+        int brightness = light2pwm(adc_handle);
+        // Any move to or from 100% counts, so the PWM pause is never held off
+        bool changed = last_brightness < 0 ||
+                       ((brightness >= 100 || last_brightness >= 100) && brightness != last_brightness) ||
+                       abs(brightness - last_brightness) > BRIGHTNESS_DEADBAND;
+        if (changed) {
+            pwm_update(display, brightness);
+            last_brightness = brightness;
+            ESP_LOGI(TAG, "brightness set to: %d", brightness);
+        }
+
+        // Identical frames cost only a hash
+        changed |= max7219_idle_present(&idle, display);
+
+        // Sleep longer while nothing changes
+        uint32_t delay_ms = max7219_idle_next_delay_ms(&idle, changed);
+        if (idle.wakeups % IDLE_STATS_EVERY == 0) {
+            ESP_LOGI(TAG, "idle: %lu wakeups, %lu frames sent, %lu skipped, %lu bus bytes saved",
+                     (unsigned long)idle.wakeups, (unsigned long)idle.frames_presented,
+                     (unsigned long)idle.frames_skipped, (unsigned long)idle.bus_bytes_saved);
+        }
+        vTaskDelay(pdMS_TO_TICKS(delay_ms));
     }
 }
 
@@ -209,29 +290,76 @@ static void max7219_scrolling_task(void *pvParameters)
     uint16_t message_width = max7219_get_string_width(message);
     int16_t scroll_pos = MAX7219_DISPLAY_WIDTH;
 
+    // Governor picks period, step and SPI clock from measured frame cost
+    max7219_governor_config_t gov_config = {
+        .nominal_period_ms = SCROLL_DELAY_MS,
+        .min_period_ms = SCROLL_MIN_PERIOD_MS,
+        .max_period_ms = SCROLL_MAX_PERIOD_MS,
+        .max_step = SCROLL_MAX_STEP,
+        .min_clock_hz = SPI_CLOCK_MIN_HZ,
+        .max_clock_hz = SPI_CLOCK_MAX_HZ,
+        .cpu_target_pct = CPU_TARGET_PCT,
+        .bus_target_pct = BUS_TARGET_PCT,
+    };
+    max7219_governor_t gov;
+    max7219_governor_init(&gov, &gov_config, display);
+    TickType_t last_wake = xTaskGetTickCount();
+
+    // Static: the idle manager holds a batch buffer too big for this stack
+    static max7219_idle_t idle;
+    max7219_idle_config_t idle_config = {
+        .min_delay_ms = SCROLL_DELAY_MS,
+        .max_delay_ms = SCROLL_DELAY_MS,  // Scroll timing comes from the governor
+        .shutdown_blank = true,
+        .reduce_scan_limit = false,       // Scrolling text lights every row
+    };
+    max7219_idle_init(&idle, &idle_config);
+
     while (1) {
         // Update brightness from ambient light sensor
         uint8_t brightness = light2pwm(adc_handle);
-        pwm_set_brightness(brightness);
+        pwm_update(display, brightness);
 
-        // Update display content
+        // Update display content (only changed rows go to the bus)
+        max7219_governor_frame_start(&gov);
         max7219_draw_string(display, scroll_pos, message);
-        max7219_refresh(display);
+        max7219_governor_render_done(&gov);
+        max7219_idle_present(&idle, display);
+        max7219_governor_frame_done(&gov, display);
 
         // Move scroll position
-        scroll_pos--;
+        scroll_pos -= gov.step;
         if (scroll_pos < -(int16_t)message_width) {
             scroll_pos = MAX7219_DISPLAY_WIDTH;
         }
 
-        // Simple delay for scroll timing - PWM runs independently in hardware
-        vTaskDelay(pdMS_TO_TICKS(SCROLL_DELAY_MS));
+        // Fixed-rate delay so frame cost does not stretch the period - PWM runs independently in hardware
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(gov.period_ms));
     }
 }
 
 void app_main(void)
 {
     ESP_LOGI(TAG, "MAX7219 32x8 LED Matrix Demo (Hardware SPI)");
+
+#if CONFIG_PM_ENABLE
+    // Let the CPU light-sleep between wake-ups; drivers hold PM locks while busy.
+    // Light sleep needs tickless idle, otherwise only scale the frequency.
+    esp_pm_config_t pm_config = {
+        .max_freq_mhz = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ,
+        .min_freq_mhz = 40,  // XTAL frequency
+#if CONFIG_FREERTOS_USE_TICKLESS_IDLE
+        .light_sleep_enable = true,
+#else
+        .light_sleep_enable = false,
+#endif
+    };
+    esp_err_t pm_ret = esp_pm_configure(&pm_config);
+    if (pm_ret != ESP_OK) {
+        // Power management is an optimisation, the demo runs without it
+        ESP_LOGW(TAG, "esp_pm_configure failed: %s", esp_err_to_name(pm_ret));
+    }
+#endif
     ESP_LOGI(TAG, "Pins: MOSI=%d, CS=%d, CLK=%d", PIN_MOSI, PIN_CS, PIN_CLK);
 
     // Initialize the MAX7219 display
@@ -1,212 +1,15 @@
 #include "max7219.h"
+#include "max7219_trace.h"
+#include "max7219_font.h"
 #include "esp_log.h"
 #include <string.h>
 #include <stdbool.h>
 
 static const char *TAG = "MAX7219";
 
-// 5x7 font data (each character is 5 columns wide)
-// Characters are stored as 5 bytes, each byte is a column (LSB = top row)
-static const uint8_t font_5x7[][5] = {
-    // Space (32)
-    {0x00, 0x00, 0x00, 0x00, 0x00},
-    // ! (33)
-    {0x00, 0x00, 0x5F, 0x00, 0x00},
-    // " (34)
-    {0x00, 0x07, 0x00, 0x07, 0x00},
-    // # (35)
-    {0x14, 0x7F, 0x14, 0x7F, 0x14},
-    // $ (36)
-    {0x24, 0x2A, 0x7F, 0x2A, 0x12},
-    // % (37)
-    {0x23, 0x13, 0x08, 0x64, 0x62},
-    // & (38)
-    {0x36, 0x49, 0x55, 0x22, 0x50},
-    // ' (39)
-    {0x00, 0x05, 0x03, 0x00, 0x00},
-    // ( (40)
-    {0x00, 0x1C, 0x22, 0x41, 0x00},
-    // ) (41)
-    {0x00, 0x41, 0x22, 0x1C, 0x00},
-    // * (42)
-    {0x08, 0x2A, 0x1C, 0x2A, 0x08},
-    // + (43)
-    {0x08, 0x08, 0x3E, 0x08, 0x08},
-    // , (44)
-    {0x00, 0x50, 0x30, 0x00, 0x00},
-    // - (45)
-    {0x08, 0x08, 0x08, 0x08, 0x08},
-    // . (46)
-    {0x00, 0x60, 0x60, 0x00, 0x00},
-    // / (47)
-    {0x20, 0x10, 0x08, 0x04, 0x02},
-    // 0 (48)
-    {0x3E, 0x51, 0x49, 0x45, 0x3E},
-    // 1 (49)
-    {0x00, 0x42, 0x7F, 0x40, 0x00},
-    // 2 (50)
-    {0x42, 0x61, 0x51, 0x49, 0x46},
-    // 3 (51)
-    {0x21, 0x41, 0x45, 0x4B, 0x31},
-    // 4 (52)
-    {0x18, 0x14, 0x12, 0x7F, 0x10},
-    // 5 (53)
-    {0x27, 0x45, 0x45, 0x45, 0x39},
-    // 6 (54)
-    {0x3C, 0x4A, 0x49, 0x49, 0x30},
-    // 7 (55)
-    {0x01, 0x71, 0x09, 0x05, 0x03},
-    // 8 (56)
-    {0x36, 0x49, 0x49, 0x49, 0x36},
-    // 9 (57)
-    {0x06, 0x49, 0x49, 0x29, 0x1E},
-    // : (58)
-    {0x00, 0x36, 0x36, 0x00, 0x00},
-    // ; (59)
-    {0x00, 0x56, 0x36, 0x00, 0x00},
-    // < (60)
-    {0x00, 0x08, 0x14, 0x22, 0x41},
-    // = (61)
-    {0x14, 0x14, 0x14, 0x14, 0x14},
-    // > (62)
-    {0x41, 0x22, 0x14, 0x08, 0x00},
-    // ? (63)
-    {0x02, 0x01, 0x51, 0x09, 0x06},
-    // @ (64)
-    {0x32, 0x49, 0x79, 0x41, 0x3E},
-    // A (65)
-    {0x7E, 0x11, 0x11, 0x11, 0x7E},
-    // B (66)
-    {0x7F, 0x49, 0x49, 0x49, 0x36},
-    // C (67)
-    {0x3E, 0x41, 0x41, 0x41, 0x22},
-    // D (68)
-    {0x7F, 0x41, 0x41, 0x22, 0x1C},
-    // E (69)
-    {0x7F, 0x49, 0x49, 0x49, 0x41},
-    // F (70)
-    {0x7F, 0x09, 0x09, 0x01, 0x01},
-    // G (71)
-    {0x3E, 0x41, 0x41, 0x51, 0x32},
-    // H (72)
-    {0x7F, 0x08, 0x08, 0x08, 0x7F},
-    // I (73)
-    {0x00, 0x41, 0x7F, 0x41, 0x00},
-    // J (74)
-    {0x20, 0x40, 0x41, 0x3F, 0x01},
-    // K (75)
-    {0x7F, 0x08, 0x14, 0x22, 0x41},
-    // L (76)
-    {0x7F, 0x40, 0x40, 0x40, 0x40},
-    // M (77)
-    {0x7F, 0x02, 0x04, 0x02, 0x7F},
-    // N (78)
-    {0x7F, 0x04, 0x08, 0x10, 0x7F},
-    // O (79)
-    {0x3E, 0x41, 0x41, 0x41, 0x3E},
-    // P (80)
-    {0x7F, 0x09, 0x09, 0x09, 0x06},
-    // Q (81)
-    {0x3E, 0x41, 0x51, 0x21, 0x5E},
-    // R (82)
-    {0x7F, 0x09, 0x19, 0x29, 0x46},
-    // S (83)
-    {0x46, 0x49, 0x49, 0x49, 0x31},
-    // T (84)
-    {0x01, 0x01, 0x7F, 0x01, 0x01},
-    // U (85)
-    {0x3F, 0x40, 0x40, 0x40, 0x3F},
-    // V (86)
-    {0x1F, 0x20, 0x40, 0x20, 0x1F},
-    // W (87)
-    {0x7F, 0x20, 0x18, 0x20, 0x7F},
-    // X (88)
-    {0x63, 0x14, 0x08, 0x14, 0x63},
-    // Y (89)
-    {0x03, 0x04, 0x78, 0x04, 0x03},
-    // Z (90)
-    {0x61, 0x51, 0x49, 0x45, 0x43},
-    // [ (91)
-    {0x00, 0x00, 0x7F, 0x41, 0x41},
-    // \ (92)
-    {0x02, 0x04, 0x08, 0x10, 0x20},
-    // ] (93)
-    {0x41, 0x41, 0x7F, 0x00, 0x00},
-    // ^ (94)
-    {0x04, 0x02, 0x01, 0x02, 0x04},
-    // _ (95)
-    {0x40, 0x40, 0x40, 0x40, 0x40},
-    // ` (96)
-    {0x00, 0x01, 0x02, 0x04, 0x00},
-    // a (97)
-    {0x20, 0x54, 0x54, 0x54, 0x78},
-    // b (98)
-    {0x7F, 0x48, 0x44, 0x44, 0x38},
-    // c (99)
-    {0x38, 0x44, 0x44, 0x44, 0x20},
-    // d (100)
-    {0x38, 0x44, 0x44, 0x48, 0x7F},
-    // e (101)
-    {0x38, 0x54, 0x54, 0x54, 0x18},
-    // f (102)
-    {0x08, 0x7E, 0x09, 0x01, 0x02},
-    // g (103)
-    {0x08, 0x54, 0x54, 0x54, 0x3C},
-    // h (104)
-    {0x7F, 0x08, 0x04, 0x04, 0x78},
-    // i (105)
-    {0x00, 0x44, 0x7D, 0x40, 0x00},
-    // j (106)
-    {0x20, 0x40, 0x44, 0x3D, 0x00},
-    // k (107)
-    {0x00, 0x7F, 0x10, 0x28, 0x44},
-    // l (108)
-    {0x00, 0x41, 0x7F, 0x40, 0x00},
-    // m (109)
-    {0x7C, 0x04, 0x18, 0x04, 0x78},
-    // n (110)
-    {0x7C, 0x08, 0x04, 0x04, 0x78},
-    // o (111)
-    {0x38, 0x44, 0x44, 0x44, 0x38},
-    // p (112)
-    {0x7C, 0x14, 0x14, 0x14, 0x08},
-    // q (113)
-    {0x08, 0x14, 0x14, 0x18, 0x7C},
-    // r (114)
-    {0x7C, 0x08, 0x04, 0x04, 0x08},
-    // s (115)
-    {0x48, 0x54, 0x54, 0x54, 0x20},
-    // t (116)
-    {0x04, 0x3F, 0x44, 0x40, 0x20},
-    // u (117)
-    {0x3C, 0x40, 0x40, 0x20, 0x7C},
-    // v (118)
-    {0x1C, 0x20, 0x40, 0x20, 0x1C},
-    // w (119)
-    {0x3C, 0x40, 0x30, 0x40, 0x3C},
-    // x (120)
-    {0x44, 0x28, 0x10, 0x28, 0x44},
-    // y (121)
-    {0x0C, 0x50, 0x50, 0x50, 0x3C},
-    // z (122)
-    {0x44, 0x64, 0x54, 0x4C, 0x44},
-    // { (123)
-    {0x00, 0x08, 0x36, 0x41, 0x00},
-    // | (124)
-    {0x00, 0x00, 0x7F, 0x00, 0x00},
-    // } (125)
-    {0x00, 0x41, 0x36, 0x08, 0x00},
-    // ~ (126)
-    {0x08, 0x08, 0x2A, 0x1C, 0x08},
-};
-
-#define FONT_FIRST_CHAR 32
-#define FONT_LAST_CHAR 126
-#define FONT_CHAR_WIDTH 5
-#define FONT_CHAR_SPACING 1
-
 // Send data to all chips in chain
 static void max7219_send_to_all(max7219_t *dev, uint8_t reg, uint8_t data) {
+    if (!dev->spi_handle) return;  // Detached by a failed clock change
     uint8_t tx_buf[MAX7219_NUM_CHIPS * 2];
 
     // Fill buffer with same command for all chips
@@ -215,6 +18,8 @@ static void max7219_send_to_all(max7219_t *dev, uint8_t reg, uint8_t data) {
         tx_buf[i * 2 + 1] = data;
     }
 
+    max7219_trace_record(MAX7219_TRACE_ALL, (const uint8_t[]){reg, data});
+
     spi_transaction_t trans = {
         .length = MAX7219_NUM_CHIPS * 16,  // bits
         .tx_buffer = tx_buf,
@@ -225,6 +30,7 @@ static void max7219_send_to_all(max7219_t *dev, uint8_t reg, uint8_t data) {
 
 // Send a row of data (different data to each chip)
 static void max7219_send_row(max7219_t *dev, uint8_t row, const uint8_t *data) {
+    if (!dev->spi_handle) return;  // Detached by a failed clock change
     uint8_t tx_buf[MAX7219_NUM_CHIPS * 2];
 
     // Send to chips in reverse order (rightmost chip receives data first)
@@ -235,6 +41,11 @@ static void max7219_send_row(max7219_t *dev, uint8_t row, const uint8_t *data) {
         tx_buf[buf_idx + 1] = data[chip];
     }
 
+    uint8_t trace_buf[1 + MAX7219_NUM_CHIPS];
+    trace_buf[0] = MAX7219_REG_DIGIT0 + row;
+    memcpy(&trace_buf[1], data, MAX7219_NUM_CHIPS);
+    max7219_trace_record(MAX7219_TRACE_ROW, trace_buf);
+
     spi_transaction_t trans = {
         .length = MAX7219_NUM_CHIPS * 16,  // bits
         .tx_buffer = tx_buf,
@@ -243,6 +54,22 @@ static void max7219_send_row(max7219_t *dev, uint8_t row, const uint8_t *data) {
     spi_device_transmit(dev->spi_handle, &trans);
 }
 
+// Attach the chain to the SPI bus at the given clock
+static esp_err_t max7219_add_device(max7219_t *dev, int clock_speed_hz) {
+    spi_device_interface_config_t dev_cfg = {
+        .clock_speed_hz = clock_speed_hz,
+        .mode = 0,  // CPOL=0, CPHA=0
+        .spics_io_num = dev->pin_cs,
+        .queue_size = MAX7219_BATCH_MAX_FRAMES,  // Batch submits a burst
+    };
+
+    esp_err_t ret = spi_bus_add_device(dev->spi_host, &dev_cfg, &dev->spi_handle);
+    if (ret == ESP_OK) {
+        dev->clock_speed_hz = clock_speed_hz;
+    }
+    return ret;
+}
+
 esp_err_t max7219_init(max7219_t *dev, const max7219_config_t *config) {
     esp_err_t ret;
 
@@ -263,14 +90,9 @@ esp_err_t max7219_init(max7219_t *dev, const max7219_config_t *config) {
     }
 
     // Configure SPI device
-    spi_device_interface_config_t dev_cfg = {
-        .clock_speed_hz = config->clock_speed_hz,
-        .mode = 0,  // CPOL=0, CPHA=0
-        .spics_io_num = config->pin_cs,
-        .queue_size = 1,
-    };
-
-    ret = spi_bus_add_device(config->spi_host, &dev_cfg, &dev->spi_handle);
+    dev->pin_cs = config->pin_cs;
+    dev->spi_host = config->spi_host;
+    ret = max7219_add_device(dev, config->clock_speed_hz);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to add SPI device: %s", esp_err_to_name(ret));
         spi_bus_free(config->spi_host);
@@ -280,7 +102,9 @@ esp_err_t max7219_init(max7219_t *dev, const max7219_config_t *config) {
     // Store GPIO pins for ISR-safe bit-banging
     dev->pin_mosi = config->pin_mosi;
     dev->pin_clk = config->pin_clk;
-    dev->pin_cs = config->pin_cs;
+    dev->chip_enable_mask = (1u << MAX7219_NUM_CHIPS) - 1;
+
+    max7219_trace_init(MAX7219_NUM_CHIPS, config->clock_speed_hz);
 
     // Initialize all MAX7219 chips
     max7219_send_to_all(dev, MAX7219_REG_DISPLAYTEST, 0x00);  // Normal operation
@@ -297,6 +121,39 @@ esp_err_t max7219_init(max7219_t *dev, const max7219_config_t *config) {
     return ESP_OK;
 }
 
+esp_err_t max7219_set_clock_speed(max7219_t *dev, int clock_speed_hz) {
+    if (dev->spi_handle && clock_speed_hz == dev->clock_speed_hz) return ESP_OK;
+
+    int old_clock_hz = dev->clock_speed_hz;
+    esp_err_t ret;
+    if (dev->spi_handle) {
+        ret = spi_bus_remove_device(dev->spi_handle);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to remove SPI device: %s", esp_err_to_name(ret));
+            return ret;
+        }
+        dev->spi_handle = NULL;
+    }
+
+    ret = max7219_add_device(dev, clock_speed_hz);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set SPI clock to %d Hz: %s", clock_speed_hz, esp_err_to_name(ret));
+        // Put the old device back so the display keeps working
+        esp_err_t restore = max7219_add_device(dev, old_clock_hz);
+        if (restore != ESP_OK) {
+            // Writes are dropped until a later call manages to add the device
+            dev->spi_handle = NULL;
+            ESP_LOGE(TAG, "Failed to restore SPI clock %d Hz: %s, display detached",
+                     old_clock_hz, esp_err_to_name(restore));
+            return ESP_ERR_INVALID_STATE;
+        }
+        return ret;
+    }
+
+    max7219_trace_set_clock(clock_speed_hz);
+    return ESP_OK;
+}
+
 void max7219_set_intensity(max7219_t *dev, uint8_t intensity) {
     if (intensity > 15) intensity = 15;
     max7219_send_to_all(dev, MAX7219_REG_INTENSITY, intensity);
@@ -308,25 +165,31 @@ void max7219_clear(max7219_t *dev) {
         uint8_t zeros[MAX7219_NUM_CHIPS] = {0};
         max7219_send_row(dev, row, zeros);
     }
+    max7219_trace_record(MAX7219_TRACE_MARK, NULL);
+}
+
+void max7219_get_row(const max7219_t *dev, uint8_t row, uint8_t *row_data) {
+    for (int chip = 0; chip < MAX7219_NUM_CHIPS; chip++) {
+        uint8_t byte = 0;
+        // Build the row byte for this chip from 8 columns
+        for (int col = 0; col < 8; col++) {
+            int fb_col = chip * 8 + col;
+            if (dev->framebuffer[fb_col] & (1 << row)) {
+                byte |= (1 << (7 - col));
+            }
+        }
+        row_data[chip] = byte;
+    }
 }
 
 void max7219_refresh(max7219_t *dev) {
     // The MAX7219 expects data row by row, but our framebuffer is column-based
     for (int row = 0; row < 8; row++) {
         uint8_t row_data[MAX7219_NUM_CHIPS];
-        for (int chip = 0; chip < MAX7219_NUM_CHIPS; chip++) {
-            uint8_t byte = 0;
-            // Build the row byte for this chip from 8 columns
-            for (int col = 0; col < 8; col++) {
-                int fb_col = chip * 8 + col;
-                if (dev->framebuffer[fb_col] & (1 << row)) {
-                    byte |= (1 << (7 - col));
-                }
-            }
-            row_data[chip] = byte;
-        }
+        max7219_get_row(dev, row, row_data);
         max7219_send_row(dev, row, row_data);
     }
+    max7219_trace_record(MAX7219_TRACE_MARK, NULL);
 }
 
 void max7219_set_pixel(max7219_t *dev, uint8_t x, uint8_t y, uint8_t on) {
@@ -340,20 +203,20 @@ void max7219_set_pixel(max7219_t *dev, uint8_t x, uint8_t y, uint8_t on) {
 }
 
 uint8_t max7219_draw_char(max7219_t *dev, int16_t x, char c) {
-    if (c < FONT_FIRST_CHAR || c > FONT_LAST_CHAR) {
+    if (c < MAX7219_FONT_FIRST_CHAR || c > MAX7219_FONT_LAST_CHAR) {
         c = ' ';
     }
 
-    const uint8_t *glyph = font_5x7[c - FONT_FIRST_CHAR];
+    const uint8_t *glyph = max7219_font_5x7[c - MAX7219_FONT_FIRST_CHAR];
 
-    for (int col = 0; col < FONT_CHAR_WIDTH; col++) {
+    for (int col = 0; col < MAX7219_FONT_CHAR_WIDTH; col++) {
         int16_t px = x + col;
         if (px >= 0 && px < MAX7219_DISPLAY_WIDTH) {
             dev->framebuffer[px] = glyph[col];
         }
     }
 
-    return FONT_CHAR_WIDTH;
+    return MAX7219_FONT_CHAR_WIDTH;
 }
 
 void max7219_draw_string(max7219_t *dev, int16_t x, const char *str) {
@@ -361,7 +224,7 @@ void max7219_draw_string(max7219_t *dev, int16_t x, const char *str) {
 
     while (*str) {
         uint8_t width = max7219_draw_char(dev, x, *str);
-        x += width + FONT_CHAR_SPACING;
+        x += width + MAX7219_FONT_CHAR_SPACING;
         str++;
     }
 }
@@ -369,11 +232,11 @@ void max7219_draw_string(max7219_t *dev, int16_t x, const char *str) {
 uint16_t max7219_get_string_width(const char *str) {
     uint16_t width = 0;
     while (*str) {
-        width += FONT_CHAR_WIDTH + FONT_CHAR_SPACING;
+        width += MAX7219_FONT_CHAR_WIDTH + MAX7219_FONT_CHAR_SPACING;
         str++;
     }
     if (width > 0) {
-        width -= FONT_CHAR_SPACING;  // Remove trailing space
+        width -= MAX7219_FONT_CHAR_SPACING;  // Remove trailing space
     }
     return width;
 }
@@ -383,7 +246,30 @@ void max7219_display_test(max7219_t *dev, bool enable) {
 }
 
 void max7219_set_enabled(max7219_t *dev, bool enabled) {
-    max7219_send_to_all(dev, MAX7219_REG_SHUTDOWN, enabled ? 0x01 : 0x00);
+    uint32_t mask = dev->chip_enable_mask;
+    max7219_trace_pwm_edge(enabled);
+    if (!enabled || mask == (1u << MAX7219_NUM_CHIPS) - 1) {
+        max7219_send_to_all(dev, MAX7219_REG_SHUTDOWN, enabled ? 0x01 : 0x00);
+        return;
+    }
+
+    if (!dev->spi_handle) return;
+
+    // Some chips are held in shutdown, only wake the others
+    uint8_t tx_buf[MAX7219_NUM_CHIPS * 2];
+    for (int chip = 0; chip < MAX7219_NUM_CHIPS; chip++) {
+        tx_buf[chip * 2] = MAX7219_REG_SHUTDOWN;
+        tx_buf[chip * 2 + 1] = (mask >> chip) & 1;
+    }
+
+    max7219_trace_record(MAX7219_TRACE_FRAME, tx_buf);
+
+    spi_transaction_t trans = {
+        .length = MAX7219_NUM_CHIPS * 16,  // bits
+        .tx_buffer = tx_buf,
+    };
+
+    spi_device_transmit(dev->spi_handle, &trans);
 }
 
 // ISR-safe version using GPIO bit-banging
@@ -392,6 +278,7 @@ void IRAM_ATTR max7219_set_enabled_isr(max7219_t *dev, bool enabled)
 {
     uint8_t reg = MAX7219_REG_SHUTDOWN;
     uint8_t data = enabled ? 0x01 : 0x00;
+    uint32_t mask = dev->chip_enable_mask;
 
     // Pull CS low to start transaction
     gpio_set_level(dev->pin_cs, 0);
@@ -399,6 +286,7 @@ void IRAM_ATTR max7219_set_enabled_isr(max7219_t *dev, bool enabled)
     // Send 16 bits (reg + data) to each chip in chain
     // MSB first, clock data on rising edge
     for (int chip = 0; chip < MAX7219_NUM_CHIPS; chip++) {
+        uint8_t chip_data = data & (mask >> chip);
         // Send register address (8 bits)
         for (int bit = 7; bit >= 0; bit--) {
             gpio_set_level(dev->pin_mosi, (reg >> bit) & 1);
@@ -407,7 +295,7 @@ void IRAM_ATTR max7219_set_enabled_isr(max7219_t *dev, bool enabled)
         }
         // Send data (8 bits)
         for (int bit = 7; bit >= 0; bit--) {
-            gpio_set_level(dev->pin_mosi, (data >> bit) & 1);
+            gpio_set_level(dev->pin_mosi, (chip_data >> bit) & 1);
             gpio_set_level(dev->pin_clk, 1);
             gpio_set_level(dev->pin_clk, 0);
         }
@@ -415,4 +303,72 @@ void IRAM_ATTR max7219_set_enabled_isr(max7219_t *dev, bool enabled)
 
     // Pull CS high to latch data
     gpio_set_level(dev->pin_cs, 1);
+
+    max7219_trace_pwm_edge(enabled);
+}
+
+void max7219_batch_begin(max7219_batch_t *batch) {
+    // NOOP register is 0x00, so a zeroed frame is all padding
+    memset(batch->frames, 0, sizeof(batch->frames));
+    memset(batch->depth, 0, sizeof(batch->depth));
+    batch->num_frames = 0;
+}
+
+esp_err_t max7219_batch_add(max7219_batch_t *batch, uint8_t chip, uint8_t reg, uint8_t data) {
+    if (chip >= MAX7219_NUM_CHIPS || reg == MAX7219_REG_NOOP) return ESP_ERR_INVALID_ARG;
+
+    // Take this chip's next free slot. Writes are never merged, so each chip
+    // sees its writes in the order they were added (e.g. test on/off pulses).
+    int f = batch->depth[chip];
+    if (f >= MAX7219_BATCH_MAX_FRAMES) return ESP_ERR_NO_MEM;
+
+    batch->frames[f][chip * 2] = reg;
+    batch->frames[f][chip * 2 + 1] = data;
+    batch->depth[chip] = f + 1;
+    if (batch->depth[chip] > batch->num_frames) {
+        batch->num_frames = batch->depth[chip];
+    }
+    return ESP_OK;
+}
+
+esp_err_t max7219_batch_add_all(max7219_batch_t *batch, uint8_t reg, uint8_t data) {
+    for (int chip = 0; chip < MAX7219_NUM_CHIPS; chip++) {
+        esp_err_t ret = max7219_batch_add(batch, chip, reg, data);
+        if (ret != ESP_OK) return ret;
+    }
+    return ESP_OK;
+}
+
+esp_err_t max7219_batch_submit(max7219_t *dev, max7219_batch_t *batch) {
+    esp_err_t ret = ESP_OK;
+    int queued = 0;
+
+    if (!dev->spi_handle) {
+        max7219_batch_begin(batch);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Queue every frame back to back so CS frames go out without task gaps
+    for (int f = 0; f < batch->num_frames; f++) {
+        batch->trans[f] = (spi_transaction_t){
+            .length = MAX7219_NUM_CHIPS * 16,  // bits
+            .tx_buffer = batch->frames[f],
+        };
+        ret = spi_device_queue_trans(dev->spi_handle, &batch->trans[f], portMAX_DELAY);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to queue batch frame %d: %s", f, esp_err_to_name(ret));
+            break;
+        }
+        max7219_trace_record(MAX7219_TRACE_FRAME, batch->frames[f]);
+        queued++;
+    }
+
+    // Collect results; frames must stay valid until the driver is done with them
+    for (int f = 0; f < queued; f++) {
+        spi_transaction_t *done;
+        spi_device_get_trans_result(dev->spi_handle, &done, portMAX_DELAY);
+    }
+
+    max7219_batch_begin(batch);
+    return ret;
 }
@@ -27,6 +27,9 @@
 #define MAX7219_DISPLAY_WIDTH   32  // 4 chips * 8 columns
 #define MAX7219_DISPLAY_HEIGHT  8
 
+// Batch builder: max CS frames a single batch may span
+#define MAX7219_BATCH_MAX_FRAMES 16
+
 typedef struct {
     gpio_num_t pin_mosi;    // DIN
     gpio_num_t pin_clk;     // CLK
@@ -37,16 +40,35 @@ typedef struct {
 
 typedef struct {
     spi_device_handle_t spi_handle;
+    spi_host_device_t spi_host;
+    int clock_speed_hz;     // Current SPI clock
     uint8_t framebuffer[MAX7219_DISPLAY_WIDTH];  // Column-based framebuffer
     // GPIO pins stored for ISR-safe bit-banging
     gpio_num_t pin_mosi;
     gpio_num_t pin_clk;
     gpio_num_t pin_cs;
+    // Chips allowed to leave shutdown (bit n = chip n), honoured by the ISR
+    volatile uint32_t chip_enable_mask;
 } max7219_t;
 
+// Batch of arbitrary (chip, register, value) writes, packed into CS frames.
+// Each chip fills its own frame slots in order; unused slots hold NOOP.
+typedef struct {
+    uint8_t frames[MAX7219_BATCH_MAX_FRAMES][MAX7219_NUM_CHIPS * 2];
+    uint8_t depth[MAX7219_NUM_CHIPS];   // Next free frame slot per chip
+    uint8_t num_frames;                 // Frames in use (max of depth[])
+    spi_transaction_t trans[MAX7219_BATCH_MAX_FRAMES];
+} max7219_batch_t;
+
 // Initialize the MAX7219 chain
 esp_err_t max7219_init(max7219_t *dev, const max7219_config_t *config);
 
+// Change the SPI clock at runtime (re-adds the device; not ISR-safe).
+// If the old clock cannot be restored after a failure, returns
+// ESP_ERR_INVALID_STATE and SPI writes are dropped until a later call
+// succeeds.
+esp_err_t max7219_set_clock_speed(max7219_t *dev, int clock_speed_hz);
+
 // Set display intensity (0-15)
 void max7219_set_intensity(max7219_t *dev, uint8_t intensity);
 
@@ -56,6 +78,9 @@ void max7219_clear(max7219_t *dev);
 // Update display from framebuffer
 void max7219_refresh(max7219_t *dev);
 
+// Pack one display row from the framebuffer (one byte per chip)
+void max7219_get_row(const max7219_t *dev, uint8_t row, uint8_t *row_data);
+
 // Set a single pixel
 void max7219_set_pixel(max7219_t *dev, uint8_t x, uint8_t y, uint8_t on);
 
@@ -77,4 +102,17 @@ void max7219_set_enabled(max7219_t *dev, bool enabled);
 // ISR-safe version using GPIO bit-banging (for hardware timer PWM)
 void max7219_set_enabled_isr(max7219_t *dev, bool enabled);
 
+// Start an empty batch
+void max7219_batch_begin(max7219_batch_t *batch);
+
+// Queue a register write for one chip (0 = first entry of a row, as in the
+// framebuffer). Per-chip write order is kept; repeated writes are not merged.
+esp_err_t max7219_batch_add(max7219_batch_t *batch, uint8_t chip, uint8_t reg, uint8_t data);
+
+// Queue the same register write for every chip
+esp_err_t max7219_batch_add_all(max7219_batch_t *batch, uint8_t reg, uint8_t data);
+
+// Send all frames of the batch as one queued burst, then empty the batch
+esp_err_t max7219_batch_submit(max7219_t *dev, max7219_batch_t *batch);
+
 #endif // MAX7219_H
@@ -0,0 +1,17 @@
+#ifndef MAX7219_FONT_H
+#define MAX7219_FONT_H
+
+// 5x7 font shared by the driver and the video-wall renderer.
+// Plain C with no ESP-IDF dependencies so it also builds on a host.
+
+#include <stdint.h>
+
+#define MAX7219_FONT_FIRST_CHAR     32
+#define MAX7219_FONT_LAST_CHAR      126
+#define MAX7219_FONT_CHAR_WIDTH     5
+#define MAX7219_FONT_CHAR_SPACING   1
+
+// Glyphs for FIRST_CHAR..LAST_CHAR, one byte per column (LSB = top row)
+extern const uint8_t max7219_font_5x7[][MAX7219_FONT_CHAR_WIDTH];
+
+#endif // MAX7219_FONT_H
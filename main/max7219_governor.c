@@ -0,0 +1,91 @@
+#include "max7219_governor.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+static const char *TAG = "MAX7219_GOV";
+
+// Bits clocked out by one max7219_refresh(): 8 row frames of 16 bits per chip
+#define REFRESH_BITS    (8 * MAX7219_NUM_CHIPS * 16)
+
+// Exponential moving average with 1/8 weight, seeded by the first sample
+static uint32_t smooth(uint32_t avg, uint32_t sample)
+{
+    if (avg == 0) return sample;
+    return avg + ((int32_t)(sample - avg) / 8);
+}
+
+void max7219_governor_init(max7219_governor_t *gov, const max7219_governor_config_t *config,
+                           const max7219_t *dev)
+{
+    gov->config = *config;
+    if (gov->config.max_step < 1) gov->config.max_step = 1;
+    if (gov->config.max_step > 3) gov->config.max_step = 3;
+    if (gov->config.cpu_target_pct == 0) gov->config.cpu_target_pct = 100;
+    if (gov->config.bus_target_pct == 0) gov->config.bus_target_pct = 100;
+
+    gov->frame_start_us = 0;
+    gov->render_done_us = 0;
+    gov->render_us = 0;
+    gov->refresh_us = 0;
+    gov->period_ms = config->nominal_period_ms;
+    gov->step = 1;
+    gov->clock_hz = dev->clock_speed_hz;
+}
+
+void max7219_governor_frame_start(max7219_governor_t *gov)
+{
+    gov->frame_start_us = esp_timer_get_time();
+}
+
+void max7219_governor_render_done(max7219_governor_t *gov)
+{
+    gov->render_done_us = esp_timer_get_time();
+}
+
+void max7219_governor_frame_done(max7219_governor_t *gov, max7219_t *dev)
+{
+    const max7219_governor_config_t *cfg = &gov->config;
+    int64_t now = esp_timer_get_time();
+
+    gov->render_us = smooth(gov->render_us, gov->render_done_us - gov->frame_start_us);
+    gov->refresh_us = smooth(gov->refresh_us, now - gov->render_done_us);
+
+    // Shortest period that keeps the CPU share under target
+    uint32_t cost_us = gov->render_us + gov->refresh_us;
+    uint32_t need_ms = (cost_us * 100 / cfg->cpu_target_pct + 999) / 1000;
+    if (need_ms < cfg->min_period_ms) need_ms = cfg->min_period_ms;
+
+    // Smallest step whose period (step * nominal) covers it keeps speed exact
+    uint8_t step = 1;
+    while (step < cfg->max_step && step * cfg->nominal_period_ms < need_ms) step++;
+    uint32_t period_ms = step * cfg->nominal_period_ms;
+    bool overloaded = period_ms < need_ms;
+    if (overloaded) period_ms = need_ms;  // Out of steps: slow down instead
+    if (period_ms > cfg->max_period_ms) period_ms = cfg->max_period_ms;
+
+    if (step != gov->step || period_ms != gov->period_ms) {
+        ESP_LOGI(TAG, "cost %lu us: step %d, period %lu ms",
+                 (unsigned long)cost_us, step, (unsigned long)period_ms);
+    }
+    gov->step = step;
+    gov->period_ms = period_ms;
+
+    // Slowest SPI clock that keeps the bus share under target. Overload
+    // asks for the fastest clock since refresh time is part of the cost.
+    uint32_t bus_budget_us = period_ms * 10 * cfg->bus_target_pct;  // ms * 1000 * pct / 100
+    int clock_hz = (int)(((uint64_t)REFRESH_BITS * 1000000 + bus_budget_us - 1) / bus_budget_us);
+    if (overloaded) clock_hz = cfg->max_clock_hz;
+    if (clock_hz < cfg->min_clock_hz) clock_hz = cfg->min_clock_hz;
+    if (clock_hz > cfg->max_clock_hz) clock_hz = cfg->max_clock_hz;
+
+    // Raise at once; only lower when idle at step 1 and well below, to avoid
+    // hunting (a slower clock also lengthens the refresh)
+    bool raise = clock_hz > gov->clock_hz;
+    bool lower = step == 1 && clock_hz < gov->clock_hz / 2;
+    if (raise || lower) {
+        if (max7219_set_clock_speed(dev, clock_hz) == ESP_OK) {
+            ESP_LOGI(TAG, "SPI clock %d -> %d Hz", gov->clock_hz, clock_hz);
+            gov->clock_hz = clock_hz;
+        }
+    }
+}
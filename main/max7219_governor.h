@@ -0,0 +1,50 @@
+#ifndef MAX7219_GOVERNOR_H
+#define MAX7219_GOVERNOR_H
+
+// Adaptive frame-rate governor for scrolling.
+//
+// Measures render and refresh time per frame and, within configured bounds,
+// picks the frame period, the scroll step (columns per frame) and the SPI
+// clock. Scroll speed stays at one column per nominal period while CPU and
+// bus utilisation are held under their targets.
+
+#include <stdint.h>
+#include "max7219.h"
+
+typedef struct {
+    uint32_t nominal_period_ms; // Period for a 1-column step (sets the scroll speed)
+    uint32_t min_period_ms;     // Shortest allowed frame period
+    uint32_t max_period_ms;     // Longest allowed frame period; only slows
+                                // the scroll if above max_step * nominal
+    uint8_t max_step;           // Largest scroll step in columns (1-3)
+    int min_clock_hz;           // SPI clock bounds
+    int max_clock_hz;
+    uint8_t cpu_target_pct;     // Max share of the frame period spent rendering + refreshing
+    uint8_t bus_target_pct;     // Max share of the frame period the SPI bus is busy
+} max7219_governor_config_t;
+
+typedef struct {
+    max7219_governor_config_t config;
+    int64_t frame_start_us;
+    int64_t render_done_us;
+    uint32_t render_us;         // Smoothed render time
+    uint32_t refresh_us;        // Smoothed refresh time
+    uint32_t period_ms;         // Chosen frame period
+    uint8_t step;               // Chosen scroll step
+    int clock_hz;               // Chosen SPI clock
+} max7219_governor_t;
+
+// Start at step 1, the nominal period and the device's current SPI clock
+void max7219_governor_init(max7219_governor_t *gov, const max7219_governor_config_t *config,
+                           const max7219_t *dev);
+
+// Call before drawing the frame
+void max7219_governor_frame_start(max7219_governor_t *gov);
+
+// Call after drawing, before max7219_refresh()
+void max7219_governor_render_done(max7219_governor_t *gov);
+
+// Call after max7219_refresh(); updates period, step and clock for the next frame
+void max7219_governor_frame_done(max7219_governor_t *gov, max7219_t *dev);
+
+#endif // MAX7219_GOVERNOR_H
@@ -0,0 +1,118 @@
+#include "max7219_idle.h"
+#include "max7219_trace.h"
+#include <string.h>
+
+// Bus bytes of one full max7219_refresh()
+#define FULL_REFRESH_BYTES  (8 * MAX7219_NUM_CHIPS * 2)
+
+// 32-bit FNV-1a
+static uint32_t frame_hash(const uint8_t *data, size_t len)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void max7219_idle_init(max7219_idle_t *idle, const max7219_idle_config_t *config)
+{
+    memset(idle, 0, sizeof(*idle));
+    idle->config = *config;
+    idle->delay_ms = config->min_delay_ms;
+    max7219_batch_begin(&idle->batch);
+}
+
+void max7219_idle_invalidate(max7219_idle_t *idle)
+{
+    idle->synced = false;
+}
+
+bool max7219_idle_present(max7219_idle_t *idle, max7219_t *dev)
+{
+    uint32_t hash = frame_hash(dev->framebuffer, sizeof(dev->framebuffer));
+    if (idle->synced && hash == idle->frame_hash) {
+        idle->frames_skipped++;
+        idle->bus_bytes_saved += FULL_REFRESH_BYTES;
+        return false;
+    }
+
+    uint8_t rows[8][MAX7219_NUM_CHIPS];
+    for (int row = 0; row < 8; row++) {
+        max7219_get_row(dev, row, rows[row]);
+    }
+
+    uint32_t mask = dev->chip_enable_mask;
+    max7219_batch_t *batch = &idle->batch;
+
+    for (int chip = 0; chip < MAX7219_NUM_CHIPS; chip++) {
+        uint32_t bit = 1u << chip;
+        int top = -1;
+        for (int row = 0; row < 8; row++) {
+            if (rows[row][chip]) top = row;
+        }
+        bool sleep = top < 0 && idle->config.shutdown_blank;
+
+        // Going to sleep: shut down first so no stale rows flash
+        if (sleep && (!idle->synced || (mask & bit))) {
+            max7219_batch_add(batch, chip, MAX7219_REG_SHUTDOWN, 0x00);
+            mask &= ~bit;
+        }
+
+        uint8_t limit = 7;
+        if (idle->config.reduce_scan_limit) {
+            limit = (top < MAX7219_IDLE_MIN_SCANLIMIT) ? MAX7219_IDLE_MIN_SCANLIMIT : top;
+        }
+        if (!sleep && (!idle->synced || limit != idle->scan_limit[chip])) {
+            max7219_batch_add(batch, chip, MAX7219_REG_SCANLIMIT, limit);
+            idle->scan_limit[chip] = limit;
+        }
+
+        // Rows above the scan limit are dark in the new frame and not
+        // scanned, so they are only sent once the limit grows again
+        for (int row = 0; row < 8; row++) {
+            bool visible = !sleep && row <= limit;
+            if (!idle->synced || (visible && rows[row][chip] != idle->rows[row][chip])) {
+                max7219_batch_add(batch, chip, MAX7219_REG_DIGIT0 + row, rows[row][chip]);
+                idle->rows[row][chip] = rows[row][chip];
+            }
+        }
+
+        // Waking up: content first, then leave shutdown
+        if (!sleep && (!idle->synced || !(mask & bit))) {
+            max7219_batch_add(batch, chip, MAX7219_REG_SHUTDOWN, 0x01);
+            mask |= bit;
+        }
+    }
+
+    // Publish the mask before the batch so the PWM ISR keeps sleepers down
+    dev->chip_enable_mask = mask;
+
+    uint32_t sent = batch->num_frames * MAX7219_NUM_CHIPS * 2;
+    max7219_batch_submit(dev, batch);
+    max7219_trace_record(MAX7219_TRACE_MARK, NULL);
+
+    idle->synced = true;
+    idle->frame_hash = hash;
+    idle->frames_presented++;
+    idle->bus_bytes_sent += sent;
+    if (sent < FULL_REFRESH_BYTES) {
+        idle->bus_bytes_saved += FULL_REFRESH_BYTES - sent;
+    }
+    return sent > 0;
+}
+
+uint32_t max7219_idle_next_delay_ms(max7219_idle_t *idle, bool changed)
+{
+    idle->wakeups++;
+    if (changed) {
+        idle->delay_ms = idle->config.min_delay_ms;
+    } else if (idle->delay_ms < idle->config.max_delay_ms) {
+        idle->delay_ms *= 2;
+        if (idle->delay_ms > idle->config.max_delay_ms) {
+            idle->delay_ms = idle->config.max_delay_ms;
+        }
+    }
+    return idle->delay_ms;
+}
@@ -0,0 +1,62 @@
+#ifndef MAX7219_IDLE_H
+#define MAX7219_IDLE_H
+
+// Power-aware idle manager.
+//
+// Presents frames in place of max7219_refresh(). Each frame is hashed and
+// identical frames are not sent at all. Changed frames send only the rows
+// that differ, in one batch. Chips that are blank are put into shutdown
+// and, optionally, the scan limit of each chip shrinks to its lowest lit row. The
+// manager also backs off the caller's wake-up period while nothing changes.
+//
+// Mixing with max7219_refresh()/max7219_clear() makes the cached chip state
+// stale; call max7219_idle_invalidate() afterwards.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "max7219.h"
+
+// Scan limits below 3 (4 digits) need a larger RSET per the datasheet, so
+// the reduction never goes below this. A lower limit also makes each
+// scanned row brighter (by 8 / (limit + 1)), since fewer rows share the scan
+// time. Intensity is not compensated, so reduce_scan_limit is best left off
+// unless the content's height is fixed.
+#define MAX7219_IDLE_MIN_SCANLIMIT  3
+
+typedef struct {
+    uint32_t min_delay_ms;      // Wake-up period while content changes
+    uint32_t max_delay_ms;      // Longest wake-up period when idle
+    bool shutdown_blank;        // Put blank chips into shutdown
+    bool reduce_scan_limit;     // Shrink scan limit to the lit rows (brightens them)
+} max7219_idle_config_t;
+
+typedef struct {
+    max7219_idle_config_t config;
+    bool synced;                // Cached chip state below is valid
+    uint32_t frame_hash;        // Hash of the last presented framebuffer
+    uint8_t rows[8][MAX7219_NUM_CHIPS];     // Digit registers as last sent
+    uint8_t scan_limit[MAX7219_NUM_CHIPS];
+    uint32_t delay_ms;          // Current wake-up period
+    max7219_batch_t batch;
+
+    // Counters
+    uint32_t wakeups;           // Calls to max7219_idle_next_delay_ms()
+    uint32_t frames_presented;  // Frames that went to the bus
+    uint32_t frames_skipped;    // Identical frames not sent
+    uint32_t bus_bytes_sent;
+    uint32_t bus_bytes_saved;   // Compared to a full max7219_refresh()
+} max7219_idle_t;
+
+void max7219_idle_init(max7219_idle_t *idle, const max7219_idle_config_t *config);
+
+// Forget the cached chip state; the next present sends everything
+void max7219_idle_invalidate(max7219_idle_t *idle);
+
+// Show dev->framebuffer. Returns true if anything was sent.
+bool max7219_idle_present(max7219_idle_t *idle, max7219_t *dev);
+
+// Count a wake-up and return how long to sleep before the next one. The
+// period doubles while nothing changes and drops back on any change.
+uint32_t max7219_idle_next_delay_ms(max7219_idle_t *idle, bool changed);
+
+#endif // MAX7219_IDLE_H
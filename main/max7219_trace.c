@@ -0,0 +1,297 @@
+#include "max7219_trace.h"
+
+#if MAX7219_TRACE_ENABLE
+
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_attr.h"
+#include "esp_timer.h"
+
+// Byte ring of variable-length records. tail is the oldest record, head is
+// where the next one goes; used tracks the bytes in between.
+static uint8_t trace_ring[MAX7219_TRACE_BUF_SIZE];
+static size_t trace_head = 0;
+static size_t trace_tail = 0;
+static size_t trace_used = 0;
+static bool trace_enabled = true;
+static int trace_num_chips = 0;
+
+// Chip registers and SPI clock, as replayed from records
+typedef struct {
+    uint8_t regs[MAX7219_TRACE_MAX_CHIPS][16];
+    uint32_t clock_hz;
+} trace_shadow_t;
+
+// State just before the oldest record in the ring
+static trace_shadow_t trace_base;
+static uint32_t trace_base_us = 0;
+
+// State as last written, recorded or not. Writes while paused only land
+// here; trace_missed then restarts the trace from it on resume.
+static trace_shadow_t trace_live;
+static bool trace_missed = false;
+static uint32_t trace_last_us = 0;
+
+// PWM edges since the last MARK, which closed its window at pwm_window_us
+static uint32_t pwm_window_us = 0;
+static uint32_t pwm_edges = 0;
+static uint32_t pwm_on_us = 0;
+static uint32_t pwm_edge_us = 0;
+static bool pwm_on = true;
+
+// Shared by tasks and the PWM timer ISR
+static portMUX_TYPE trace_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static inline size_t IRAM_ATTR ring_wrap(size_t idx)
+{
+    return (idx >= MAX7219_TRACE_BUF_SIZE) ? idx - MAX7219_TRACE_BUF_SIZE : idx;
+}
+
+// Copy into the ring at head, splitting at the end of the buffer
+static inline void IRAM_ATTR ring_put(const uint8_t *src, size_t len)
+{
+    size_t first = MAX7219_TRACE_BUF_SIZE - trace_head;
+    if (first > len) first = len;
+    memcpy(&trace_ring[trace_head], src, first);
+    memcpy(trace_ring, src + first, len - first);
+    trace_head = ring_wrap(trace_head + len);
+}
+
+// Copy len bytes out of the ring starting at idx
+static void IRAM_ATTR ring_get(uint8_t *dst, size_t idx, size_t len)
+{
+    size_t first = MAX7219_TRACE_BUF_SIZE - idx;
+    if (first > len) first = len;
+    memcpy(dst, &trace_ring[idx], first);
+    memcpy(dst + first, trace_ring, len - first);
+}
+
+static inline uint32_t IRAM_ATTR get_u32(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Apply a record's register writes or clock change to a shadow
+static void IRAM_ATTR shadow_apply(trace_shadow_t *shadow, uint8_t kind, const uint8_t *p)
+{
+    if (kind == MAX7219_TRACE_CLOCK) {
+        shadow->clock_hz = get_u32(p);
+        return;
+    }
+    for (int chip = 0; chip < trace_num_chips; chip++) {
+        uint8_t reg, data;
+        if (kind == MAX7219_TRACE_ALL) {
+            reg = p[0];
+            data = p[1];
+        } else if (kind == MAX7219_TRACE_ROW) {
+            reg = p[0];
+            data = p[1 + chip];
+        } else if (kind == MAX7219_TRACE_FRAME) {
+            reg = p[chip * 2];
+            data = p[chip * 2 + 1];
+        } else {
+            break;
+        }
+        shadow->regs[chip][reg & 0x0F] = data;
+    }
+}
+
+// Fold the oldest record into the register shadow and drop it
+static void IRAM_ATTR drop_oldest(void)
+{
+    uint8_t rec[MAX7219_TRACE_REC_HEADER + 2 * MAX7219_TRACE_MAX_CHIPS];
+    size_t len = max7219_trace_record_len(trace_ring[trace_tail], trace_num_chips);
+
+    ring_get(rec, trace_tail, len);
+    shadow_apply(&trace_base, rec[0], &rec[MAX7219_TRACE_REC_HEADER]);
+    trace_base_us = get_u32(&rec[1]);
+
+    trace_tail = ring_wrap(trace_tail + len);
+    trace_used -= len;
+}
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)(v);
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static void fill_header(uint8_t *hdr)
+{
+    memcpy(hdr, MAX7219_TRACE_MAGIC, 4);
+    hdr[4] = MAX7219_TRACE_VERSION;
+    hdr[5] = (uint8_t)trace_num_chips;
+    hdr[6] = 0;
+    hdr[7] = 0;
+    put_u32(&hdr[8], trace_live.clock_hz);
+}
+
+// Header plus the STATE record for trace_base
+static size_t fill_prologue(uint8_t *dst)
+{
+    uint8_t *rec = dst + MAX7219_TRACE_HEADER_SIZE;
+    fill_header(dst);
+    rec[0] = MAX7219_TRACE_STATE;
+    put_u32(&rec[1], trace_base_us);
+    put_u32(&rec[MAX7219_TRACE_REC_HEADER], trace_base.clock_hz);
+    memcpy(&rec[MAX7219_TRACE_REC_HEADER + 4], trace_base.regs, 16 * trace_num_chips);
+    return MAX7219_TRACE_HEADER_SIZE + max7219_trace_record_len(MAX7219_TRACE_STATE, trace_num_chips);
+}
+
+// Empty the ring and restart the trace from the live registers
+static void restart_locked(void)
+{
+    trace_head = trace_tail = trace_used = 0;
+    trace_base = trace_live;
+    trace_base_us = trace_last_us;
+    trace_missed = false;
+}
+
+static void reset_locked(uint32_t spi_clock_hz)
+{
+    trace_head = trace_tail = trace_used = 0;
+    memset(&trace_live, 0, sizeof(trace_live));
+    trace_live.clock_hz = spi_clock_hz;
+    trace_base = trace_live;
+    trace_base_us = 0;
+    trace_last_us = 0;
+    trace_missed = false;
+    pwm_edges = 0;
+    pwm_on_us = 0;
+}
+
+void max7219_trace_init(int num_chips, uint32_t spi_clock_hz)
+{
+    if (num_chips > MAX7219_TRACE_MAX_CHIPS) num_chips = MAX7219_TRACE_MAX_CHIPS;
+
+    portENTER_CRITICAL_SAFE(&trace_lock);
+    trace_num_chips = num_chips;
+    reset_locked(spi_clock_hz);
+    pwm_edge_us = (uint32_t)esp_timer_get_time();
+    pwm_window_us = pwm_edge_us;
+    portEXIT_CRITICAL_SAFE(&trace_lock);
+}
+
+void max7219_trace_set_clock(uint32_t spi_clock_hz)
+{
+    uint8_t payload[4];
+    put_u32(payload, spi_clock_hz);
+    max7219_trace_record(MAX7219_TRACE_CLOCK, payload);
+}
+
+void max7219_trace_set_enabled(bool enabled)
+{
+    portENTER_CRITICAL_SAFE(&trace_lock);
+    // The ring no longer leads up to the chip state if writes were missed
+    if (enabled && trace_missed) restart_locked();
+    trace_enabled = enabled;
+    portEXIT_CRITICAL_SAFE(&trace_lock);
+}
+
+void IRAM_ATTR max7219_trace_pwm_edge(bool on)
+{
+    uint32_t t_us = (uint32_t)esp_timer_get_time();
+
+    portENTER_CRITICAL_SAFE(&trace_lock);
+    if (pwm_on) pwm_on_us += t_us - pwm_edge_us;
+    pwm_edge_us = t_us;
+    pwm_on = on;
+    pwm_edges++;
+    portEXIT_CRITICAL_SAFE(&trace_lock);
+}
+
+void IRAM_ATTR max7219_trace_record(uint8_t kind, const uint8_t *payload)
+{
+    size_t len = max7219_trace_record_len(kind, trace_num_chips);
+    if (len == 0 || kind == MAX7219_TRACE_STATE || len > MAX7219_TRACE_BUF_SIZE) return;
+
+    // Timestamp is taken outside the lock; records stay in bus order anyway
+    uint32_t t_us = (uint32_t)esp_timer_get_time();
+    uint8_t hdr[MAX7219_TRACE_REC_HEADER] = {
+        kind,
+        (uint8_t)(t_us), (uint8_t)(t_us >> 8), (uint8_t)(t_us >> 16), (uint8_t)(t_us >> 24),
+    };
+    uint8_t mark[12];
+
+    portENTER_CRITICAL_SAFE(&trace_lock);
+    if (kind == MAX7219_TRACE_MARK) {
+        // Close the PWM accounting window at this frame
+        if (pwm_on) pwm_on_us += t_us - pwm_edge_us;
+        pwm_edge_us = t_us;
+        put_u32(&mark[0], pwm_edges);
+        put_u32(&mark[4], pwm_on_us);
+        put_u32(&mark[8], pwm_window_us);
+        pwm_window_us = t_us;
+        pwm_edges = 0;
+        pwm_on_us = 0;
+        payload = mark;
+    }
+    shadow_apply(&trace_live, kind, payload);
+    trace_last_us = t_us;
+    if (trace_enabled) {
+        // Drop oldest records until the new one fits
+        while (MAX7219_TRACE_BUF_SIZE - trace_used < len) {
+            drop_oldest();
+        }
+        ring_put(hdr, sizeof(hdr));
+        if (len > sizeof(hdr)) ring_put(payload, len - sizeof(hdr));
+        trace_used += len;
+    } else if (kind != MAX7219_TRACE_MARK) {
+        trace_missed = true;
+    }
+    portEXIT_CRITICAL_SAFE(&trace_lock);
+}
+
+void max7219_trace_clear(void)
+{
+    // The trace restarts from the current state of the chips
+    portENTER_CRITICAL_SAFE(&trace_lock);
+    restart_locked();
+    portEXIT_CRITICAL_SAFE(&trace_lock);
+}
+
+size_t max7219_trace_snapshot(uint8_t *dst, size_t max_len)
+{
+    if (max_len < MAX7219_TRACE_HEADER_SIZE + max7219_trace_record_len(MAX7219_TRACE_STATE, trace_num_chips)) {
+        return 0;
+    }
+
+    portENTER_CRITICAL_SAFE(&trace_lock);
+    size_t out = fill_prologue(dst);
+
+    // Copy whole records only, newest ones are cut if dst is too small
+    size_t idx = trace_tail;
+    size_t left = trace_used;
+    while (left > 0) {
+        size_t len = max7219_trace_record_len(trace_ring[idx], trace_num_chips);
+        if (out + len > max_len) break;
+        ring_get(dst + out, idx, len);
+        out += len;
+        idx = ring_wrap(idx + len);
+        left -= len;
+    }
+    portEXIT_CRITICAL_SAFE(&trace_lock);
+
+    return out;
+}
+
+void max7219_trace_print(void)
+{
+    // Copy under the lock like a snapshot; printing is slow and the driver
+    // keeps writing meanwhile
+    static uint8_t dump[MAX7219_TRACE_HEADER_SIZE + MAX7219_TRACE_REC_HEADER + 4 +
+                        16 * MAX7219_TRACE_MAX_CHIPS + MAX7219_TRACE_BUF_SIZE];
+    size_t len = max7219_trace_snapshot(dump, sizeof(dump));
+
+    // 32 bytes per line
+    for (size_t i = 0; i < len; i++) {
+        if (i % 32 == 0) printf("M7TR:");
+        printf("%02x", dump[i]);
+        if (i % 32 == 31 || i == len - 1) printf("\n");
+    }
+}
+
+#endif // MAX7219_TRACE_ENABLE
@@ -0,0 +1,111 @@
+#ifndef MAX7219_TRACE_H
+#define MAX7219_TRACE_H
+
+// SPI bus trace for the MAX7219 chain.
+//
+// Every transaction sent by the driver is appended to a fixed-size RAM ring
+// as a small binary record. The oldest records are dropped when the ring is
+// full, and folded into a shadow of the chip registers and SPI clock so a
+// snapshot always starts with the full chain state. PWM edges from the ISR are only counted
+// and carried in the next frame marker, so they never flood the ring.
+// A snapshot (or a hex dump printed to the console) can be replayed on a
+// host with tools/max7219_trace_decode.c.
+//
+// This header is plain C so the host tool can share the format definitions.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// Recording is compiled in by default; define as 0 to remove it entirely
+#ifndef MAX7219_TRACE_ENABLE
+#define MAX7219_TRACE_ENABLE    1
+#endif
+
+// Ring size in bytes (a 4-chip refresh takes 8 * 10 + 17 = 97 bytes)
+#ifndef MAX7219_TRACE_BUF_SIZE
+#define MAX7219_TRACE_BUF_SIZE  2048
+#endif
+
+// Snapshot header: "M7TR", version, chip count, reserved, SPI clock at the
+// time of the dump (LE)
+#define MAX7219_TRACE_MAGIC         "M7TR"
+#define MAX7219_TRACE_VERSION       4
+#define MAX7219_TRACE_HEADER_SIZE   12
+
+// Record layout: kind (1 byte), timestamp in us (uint32 LE), payload
+#define MAX7219_TRACE_REC_HEADER    5
+
+// Largest chain the register shadow can hold
+#define MAX7219_TRACE_MAX_CHIPS     16
+
+typedef enum {
+    MAX7219_TRACE_ALL   = 1,    // Same register to every chip: reg, data
+    MAX7219_TRACE_ROW   = 2,    // One register, per-chip data: reg, data[n]
+    // 3 was the per-edge ISR record of version 1
+    MAX7219_TRACE_FRAME = 4,    // Raw CS frame: (reg, data) per chip
+    MAX7219_TRACE_MARK  = 5,    // End of a displayed frame: PWM edges, PWM on-time in us,
+                                // frame start in us (uint32 LE each)
+    MAX7219_TRACE_STATE = 6,    // Snapshot only, first record: SPI clock (uint32 LE),
+                                // then registers 0-15 of every chip
+    MAX7219_TRACE_CLOCK = 7,    // SPI clock change: clock in Hz (uint32 LE)
+} max7219_trace_kind_t;
+
+// Total record size for a kind, or 0 if the kind is unknown
+static inline size_t max7219_trace_record_len(uint8_t kind, int num_chips)
+{
+    switch (kind) {
+        case MAX7219_TRACE_ALL:   return MAX7219_TRACE_REC_HEADER + 2;
+        case MAX7219_TRACE_ROW:   return MAX7219_TRACE_REC_HEADER + 1 + num_chips;
+        case MAX7219_TRACE_FRAME: return MAX7219_TRACE_REC_HEADER + 2 * num_chips;
+        case MAX7219_TRACE_MARK:  return MAX7219_TRACE_REC_HEADER + 12;
+        case MAX7219_TRACE_STATE: return MAX7219_TRACE_REC_HEADER + 4 + 16 * num_chips;
+        case MAX7219_TRACE_CLOCK: return MAX7219_TRACE_REC_HEADER + 4;
+        default:                  return 0;
+    }
+}
+
+#if MAX7219_TRACE_ENABLE
+
+// Reset the ring and remember the bus parameters for the snapshot header
+void max7219_trace_init(int num_chips, uint32_t spi_clock_hz);
+
+// Record an SPI clock change, so bus time is replayed at the right clock
+void max7219_trace_set_clock(uint32_t spi_clock_hz);
+
+// Pause or resume recording (recording starts enabled). A paused ring keeps
+// the trace up to the pause; if the driver wrote anything meanwhile, resuming
+// restarts the trace from the current chip state.
+void max7219_trace_set_enabled(bool enabled);
+
+// Append one record; payload length must match the kind (MARK fills in its
+// own payload, pass NULL). STATE is not accepted. ISR-safe.
+void max7219_trace_record(uint8_t kind, const uint8_t *payload);
+
+// Count a PWM shutdown edge (on = display enabled). ISR-safe.
+void max7219_trace_pwm_edge(bool on);
+
+// Drop all recorded data; the trace restarts from the current chip state
+void max7219_trace_clear(void);
+
+// Copy header, STATE record and records (oldest first) into dst, returns
+// bytes written
+size_t max7219_trace_snapshot(uint8_t *dst, size_t max_len);
+
+// Print the snapshot as "M7TR:" prefixed hex lines for capture from the monitor
+void max7219_trace_print(void);
+
+#else
+
+static inline void max7219_trace_init(int num_chips, uint32_t spi_clock_hz) { (void)num_chips; (void)spi_clock_hz; }
+static inline void max7219_trace_set_clock(uint32_t spi_clock_hz) { (void)spi_clock_hz; }
+static inline void max7219_trace_set_enabled(bool enabled) { (void)enabled; }
+static inline void max7219_trace_record(uint8_t kind, const uint8_t *payload) { (void)kind; (void)payload; }
+static inline void max7219_trace_pwm_edge(bool on) { (void)on; }
+static inline void max7219_trace_clear(void) {}
+static inline size_t max7219_trace_snapshot(uint8_t *dst, size_t max_len) { (void)dst; (void)max_len; return 0; }
+static inline void max7219_trace_print(void) {}
+
+#endif // MAX7219_TRACE_ENABLE
+
+#endif // MAX7219_TRACE_H
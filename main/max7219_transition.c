@@ -0,0 +1,197 @@
+#include "max7219_transition.h"
+#include <string.h>
+
+#define PIXELS          (MAX7219_DISPLAY_WIDTH * MAX7219_DISPLAY_HEIGHT)
+#define CHECKER_CELL    4
+
+// Replicate a byte into all four lanes of a word
+#define BYTES4(b)       ((uint32_t)(uint8_t)(b) * 0x01010101u)
+
+// Seed for dissolve patterns, advanced each time so repeats differ
+static uint32_t dissolve_seed = 0x2545F491;
+
+static uint32_t xorshift32(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static void set_rank(max7219_transition_t *tr, int x, int y, uint8_t rank)
+{
+    for (int b = 0; b < tr->rank_bits; b++) {
+        if (rank & (1 << b)) {
+            tr->rank[b].cols[x] |= (1 << y);
+        }
+    }
+}
+
+// Build the bit-sliced rank planes for the mask-driven effects
+static void build_ranks(max7219_transition_t *tr)
+{
+    memset(tr->rank, 0, sizeof(tr->rank));
+    tr->rank_bits = 0;
+    while ((1u << tr->rank_bits) < tr->num_steps) tr->rank_bits++;
+
+    if (tr->type == MAX7219_TRANSITION_CHECKERBOARD) {
+        // Black squares wipe in during the first half, white ones in the second
+        for (int x = 0; x < MAX7219_DISPLAY_WIDTH; x++) {
+            for (int y = 0; y < MAX7219_DISPLAY_HEIGHT; y++) {
+                int parity = ((x / CHECKER_CELL) ^ (y / CHECKER_CELL)) & 1;
+                int phase = parity * CHECKER_CELL + x % CHECKER_CELL;
+                set_rank(tr, x, y, ((phase + 1) * tr->num_steps - 1) / (2 * CHECKER_CELL));
+            }
+        }
+    } else if (tr->type == MAX7219_TRANSITION_DISSOLVE) {
+        // Shuffle so every step switches about the same number of pixels
+        uint16_t order[PIXELS];
+        for (int i = 0; i < PIXELS; i++) order[i] = i;
+        uint32_t state = dissolve_seed;
+        for (int i = PIXELS - 1; i > 0; i--) {
+            int j = xorshift32(&state) % (i + 1);
+            uint16_t tmp = order[i];
+            order[i] = order[j];
+            order[j] = tmp;
+        }
+        dissolve_seed = state;
+
+        for (int i = 0; i < PIXELS; i++) {
+            set_rank(tr, i / MAX7219_DISPLAY_HEIGHT, i % MAX7219_DISPLAY_HEIGHT,
+                     order[i] * tr->num_steps / PIXELS);
+        }
+    }
+}
+
+// Mask of pixels whose rank <= step, as a bit-sliced compare per word
+static void rank_mask(const max7219_transition_t *tr, uint16_t step, max7219_fb_words_t *mask)
+{
+    for (int w = 0; w < MAX7219_TRANSITION_WORDS; w++) {
+        uint32_t lt = 0;
+        uint32_t eq = ~0u;
+        for (int b = tr->rank_bits - 1; b >= 0; b--) {
+            uint32_t s = (step & (1 << b)) ? ~0u : 0;
+            uint32_t r = tr->rank[b].words[w];
+            lt |= eq & ~r & s;
+            eq &= ~(r ^ s);
+        }
+        mask->words[w] = lt | eq;
+    }
+}
+
+void max7219_transition_begin(max7219_transition_t *tr, max7219_transition_type_t type,
+                              const uint8_t *from, const uint8_t *to,
+                              uint16_t num_steps, uint8_t intensity)
+{
+    if (num_steps < 1) num_steps = 1;
+    if (num_steps > MAX7219_TRANSITION_MAX_STEPS) num_steps = MAX7219_TRANSITION_MAX_STEPS;
+    if (intensity > 15) intensity = 15;
+
+    tr->type = type;
+    tr->num_steps = num_steps;
+    tr->step = 0;
+    tr->intensity = intensity;
+    tr->last_intensity = intensity;
+
+    memcpy(tr->from.cols, from, MAX7219_DISPLAY_WIDTH);
+    memcpy(tr->to.cols, to, MAX7219_DISPLAY_WIDTH);
+    for (int w = 0; w < MAX7219_TRANSITION_WORDS; w++) {
+        tr->diff.words[w] = tr->from.words[w] ^ tr->to.words[w];
+    }
+
+    build_ranks(tr);
+}
+
+bool max7219_transition_step(max7219_transition_t *tr, uint8_t *out, uint8_t *intensity)
+{
+    if (tr->step >= tr->num_steps) return false;
+
+    uint16_t k = tr->step++;
+    uint16_t n = tr->num_steps;
+    max7219_fb_words_t frame;
+    max7219_fb_words_t mask;
+    *intensity = tr->intensity;
+
+    switch (tr->type) {
+        case MAX7219_TRANSITION_WIPE_LEFT:
+        case MAX7219_TRANSITION_WIPE_RIGHT: {
+            int shown = (k + 1) * MAX7219_DISPLAY_WIDTH / n;
+            memset(mask.cols, 0, sizeof(mask.cols));
+            if (tr->type == MAX7219_TRANSITION_WIPE_LEFT) {
+                memset(mask.cols, 0xFF, shown);
+            } else {
+                memset(&mask.cols[MAX7219_DISPLAY_WIDTH - shown], 0xFF, shown);
+            }
+            for (int w = 0; w < MAX7219_TRANSITION_WORDS; w++) {
+                frame.words[w] = tr->from.words[w] ^ (tr->diff.words[w] & mask.words[w]);
+            }
+            break;
+        }
+
+        case MAX7219_TRANSITION_SLIDE_LEFT: {
+            int shift = (k + 1) * MAX7219_DISPLAY_WIDTH / n;
+            memcpy(frame.cols, &tr->from.cols[shift], MAX7219_DISPLAY_WIDTH - shift);
+            memcpy(&frame.cols[MAX7219_DISPLAY_WIDTH - shift], tr->to.cols, shift);
+            break;
+        }
+
+        case MAX7219_TRANSITION_SLIDE_UP: {
+            // Shift every column byte at once; lane masks stop bits crossing columns
+            int shift = (k + 1) * MAX7219_DISPLAY_HEIGHT / n;
+            if (shift >= 8) {
+                frame = tr->to;
+            } else {
+                uint32_t keep_from = BYTES4(0xFF >> shift);
+                uint32_t keep_to = BYTES4(0xFF << (8 - shift));
+                for (int w = 0; w < MAX7219_TRANSITION_WORDS; w++) {
+                    frame.words[w] = ((tr->from.words[w] >> shift) & keep_from) |
+                                     ((tr->to.words[w] << (8 - shift)) & keep_to);
+                }
+            }
+            break;
+        }
+
+        case MAX7219_TRANSITION_CHECKERBOARD:
+        case MAX7219_TRANSITION_DISSOLVE:
+            rank_mask(tr, k, &mask);
+            for (int w = 0; w < MAX7219_TRANSITION_WORDS; w++) {
+                frame.words[w] = tr->from.words[w] ^ (tr->diff.words[w] & mask.words[w]);
+            }
+            break;
+
+        case MAX7219_TRANSITION_FADE: {
+            // Down to the lowest level on the old content, then up on the new
+            uint16_t half = n / 2;
+            if (k < half) {
+                frame = tr->from;
+                *intensity = tr->intensity - tr->intensity * (k + 1) / half;
+            } else {
+                frame = tr->to;
+                *intensity = tr->intensity * (k - half + 1) / (n - half);
+            }
+            break;
+        }
+
+        default:
+            frame = tr->to;
+            break;
+    }
+
+    memcpy(out, frame.cols, MAX7219_DISPLAY_WIDTH);
+    return true;
+}
+
+bool max7219_transition_present(max7219_t *dev, max7219_transition_t *tr)
+{
+    uint8_t intensity;
+    if (!max7219_transition_step(tr, dev->framebuffer, &intensity)) return false;
+
+    max7219_refresh(dev);
+    if (intensity != tr->last_intensity) {
+        max7219_set_intensity(dev, intensity);
+        tr->last_intensity = intensity;
+    }
+    return true;
+}
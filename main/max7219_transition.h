@@ -0,0 +1,69 @@
+#ifndef MAX7219_TRANSITION_H
+#define MAX7219_TRANSITION_H
+
+// Transition effects between two framebuffers.
+//
+// An outgoing and an incoming framebuffer are blended over a number of
+// steps. All per-pixel work is done at begin() time: the effect is turned
+// into masks (or bit-sliced per-pixel reveal ranks) and every step is a few
+// word-wide AND/XOR operations over the column bytes.
+//
+// Typical use:
+//     memcpy(from, dev->framebuffer, sizeof(from));
+//     max7219_draw_string(dev, 1, "next");
+//     max7219_transition_begin(&tr, MAX7219_TRANSITION_DISSOLVE, from, dev->framebuffer, 16, 8);
+//     while (max7219_transition_present(dev, &tr)) vTaskDelay(...);
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "max7219.h"
+
+#define MAX7219_TRANSITION_WORDS    (MAX7219_DISPLAY_WIDTH / 4)
+#define MAX7219_TRANSITION_MAX_STEPS 256
+
+_Static_assert(MAX7219_DISPLAY_WIDTH % 4 == 0, "framebuffer must be whole 32-bit words");
+
+typedef enum {
+    MAX7219_TRANSITION_WIPE_LEFT,       // Incoming appears from the left edge
+    MAX7219_TRANSITION_WIPE_RIGHT,      // Incoming appears from the right edge
+    MAX7219_TRANSITION_SLIDE_LEFT,      // Both move left, incoming enters on the right
+    MAX7219_TRANSITION_SLIDE_UP,        // Both move up, incoming enters at the bottom
+    MAX7219_TRANSITION_CHECKERBOARD,    // 4x4 squares wipe in, alternate squares first
+    MAX7219_TRANSITION_DISSOLVE,        // Pseudo-random pixels switch over
+    MAX7219_TRANSITION_FADE,            // Intensity down, swap, intensity up
+} max7219_transition_type_t;
+
+// Framebuffer viewed as column bytes or as 32-bit words
+typedef union {
+    uint8_t cols[MAX7219_DISPLAY_WIDTH];
+    uint32_t words[MAX7219_TRANSITION_WORDS];
+} max7219_fb_words_t;
+
+typedef struct {
+    max7219_transition_type_t type;
+    uint16_t num_steps;
+    uint16_t step;              // Next step to produce
+    uint8_t intensity;          // Intensity outside of a fade
+    uint8_t last_intensity;     // Last value sent by present()
+    uint8_t rank_bits;          // Bit planes used in rank[]
+    max7219_fb_words_t from;
+    max7219_fb_words_t to;
+    max7219_fb_words_t diff;    // from ^ to
+    // Bit-sliced reveal step per pixel: bit b of pixel's step is in rank[b]
+    max7219_fb_words_t rank[8];
+} max7219_transition_t;
+
+// Prepare a transition of num_steps (1-256) steps. intensity (0-15) is the
+// level to restore at the end of a fade and is ignored by other effects.
+void max7219_transition_begin(max7219_transition_t *tr, max7219_transition_type_t type,
+                              const uint8_t *from, const uint8_t *to,
+                              uint16_t num_steps, uint8_t intensity);
+
+// Produce the next frame into out (MAX7219_DISPLAY_WIDTH bytes) and the
+// intensity to show it at. Returns false once the transition is complete.
+bool max7219_transition_step(max7219_transition_t *tr, uint8_t *out, uint8_t *intensity);
+
+// Step and show the result on the display. Returns false once complete.
+bool max7219_transition_present(max7219_t *dev, max7219_transition_t *tr);
+
+#endif // MAX7219_TRANSITION_H
@@ -0,0 +1,360 @@
+#include "max7219_wall.h"
+#include "max7219_font.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef ESP_PLATFORM
+#include "esp_log.h"
+
+static const char *TAG = "MAX7219_WALL";
+#endif
+
+// Register addresses, as in max7219.h (which needs ESP-IDF)
+#define WALL_REG_DIGIT0         0x01
+#define WALL_REG_DECODE         0x09
+#define WALL_REG_INTENSITY      0x0A
+#define WALL_REG_SCANLIMIT      0x0B
+#define WALL_REG_SHUTDOWN       0x0C
+#define WALL_REG_DISPLAYTEST    0x0F
+#define WALL_CHAR_PITCH     (MAX7219_FONT_CHAR_WIDTH + MAX7219_FONT_CHAR_SPACING)
+
+// Render columns [col0, col1) of one chain, same layout as max7219_draw_string()
+static void wall_render_span(max7219_wall_t *wall, int chain, int col0, int col1)
+{
+    uint8_t *canvas = &wall->canvas[chain * wall->width];
+    const char *str = wall->lines[chain];
+    int len = str ? wall->line_len[chain] : 0;
+
+    for (int px = col0; px < col1; px++) {
+        int offset = px - wall->x;
+        uint8_t column = 0;
+        if (offset >= 0 && offset / WALL_CHAR_PITCH < len) {
+            int glyph_col = offset % WALL_CHAR_PITCH;
+            if (glyph_col < MAX7219_FONT_CHAR_WIDTH) {
+                char c = str[offset / WALL_CHAR_PITCH];
+                if (c < MAX7219_FONT_FIRST_CHAR || c > MAX7219_FONT_LAST_CHAR) c = ' ';
+                column = max7219_font_5x7[c - MAX7219_FONT_FIRST_CHAR][glyph_col];
+            }
+        }
+        canvas[px] = column;
+    }
+}
+
+// Pack modules [mod0, mod1) of one chain into its 8 row frames, same bit
+// order as max7219_refresh()
+static void wall_pack_span(max7219_wall_t *wall, int chain, int mod0, int mod1)
+{
+    const uint8_t *canvas = &wall->canvas[chain * wall->width];
+    uint8_t *tx = &wall->tx[chain * 8 * wall->frame_len];
+
+    for (int m = mod0; m < mod1; m++) {
+        const uint8_t *cols = &canvas[m * 8];
+        for (int row = 0; row < 8; row++) {
+            uint8_t byte = 0;
+            for (int col = 0; col < 8; col++) {
+                if (cols[col] & (1 << row)) {
+                    byte |= (1 << (7 - col));
+                }
+            }
+            tx[row * wall->frame_len + m * 2 + 1] = byte;
+        }
+    }
+}
+
+// Each worker takes one contiguous run of tiles, so workers only share
+// cache lines of canvas and tx where their runs meet
+static void wall_do_tiles(max7219_wall_t *wall, int worker)
+{
+    int tile_modules = wall->config.tile_modules;
+    int modules = wall->config.modules_per_chain;
+    int num_workers = wall->config.num_workers;
+    int t0 = worker * wall->num_tiles / num_workers;
+    int t1 = (worker + 1) * wall->num_tiles / num_workers;
+
+    for (int t = t0; t < t1; t++) {
+        int chain = t / wall->tiles_per_chain;
+        int mod0 = (t % wall->tiles_per_chain) * tile_modules;
+        int mod1 = mod0 + tile_modules;
+        if (mod1 > modules) mod1 = modules;
+
+        wall_render_span(wall, chain, mod0 * 8, mod1 * 8);
+        wall_pack_span(wall, chain, mod0, mod1);
+    }
+}
+
+static void *wall_worker_main(void *arg)
+{
+    max7219_wall_worker_t *w = (max7219_wall_worker_t *)arg;
+    max7219_wall_t *wall = w->wall;
+    unsigned seen = 0;
+
+    while (1) {
+        pthread_mutex_lock(&wall->lock);
+        while (wall->generation == seen && !wall->stop) {
+            pthread_cond_wait(&wall->start_cond, &wall->lock);
+        }
+        if (wall->stop) {
+            pthread_mutex_unlock(&wall->lock);
+            break;
+        }
+        seen = wall->generation;
+        pthread_mutex_unlock(&wall->lock);
+
+        wall_do_tiles(wall, w->index);
+
+        pthread_mutex_lock(&wall->lock);
+        if (--wall->pending == 0) {
+            pthread_cond_signal(&wall->done_cond);
+        }
+        pthread_mutex_unlock(&wall->lock);
+    }
+    return NULL;
+}
+
+esp_err_t max7219_wall_init(max7219_wall_t *wall, const max7219_wall_config_t *config)
+{
+    if (config->num_chains <= 0 || config->modules_per_chain <= 0 ||
+        config->tile_modules <= 0 || config->num_workers <= 0 ||
+        config->num_workers > MAX7219_WALL_MAX_WORKERS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(wall, 0, sizeof(*wall));
+    wall->config = *config;
+    wall->config.num_workers = 1;  // Counts threads actually started, for deinit
+    wall->width = config->modules_per_chain * 8;
+    wall->tiles_per_chain = (config->modules_per_chain + config->tile_modules - 1) / config->tile_modules;
+    wall->num_tiles = wall->tiles_per_chain * config->num_chains;
+    wall->frame_len = config->modules_per_chain * 2;
+
+    pthread_mutex_init(&wall->lock, NULL);
+    pthread_cond_init(&wall->start_cond, NULL);
+    pthread_cond_init(&wall->done_cond, NULL);
+
+    wall->canvas = calloc(config->num_chains, wall->width);
+    wall->tx = calloc(config->num_chains * 8, wall->frame_len);
+    wall->line_len = calloc(config->num_chains, sizeof(uint16_t));
+    if (!wall->canvas || !wall->tx || !wall->line_len) {
+        max7219_wall_deinit(wall);
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Register bytes never change, only the data bytes are packed per frame
+    for (int chain = 0; chain < config->num_chains; chain++) {
+        for (int row = 0; row < 8; row++) {
+            uint8_t *frame = &wall->tx[(chain * 8 + row) * wall->frame_len];
+            for (int m = 0; m < config->modules_per_chain; m++) {
+                frame[m * 2] = WALL_REG_DIGIT0 + row;
+            }
+        }
+    }
+
+    for (int i = 1; i < config->num_workers; i++) {
+        wall->workers[i].wall = wall;
+        wall->workers[i].index = i;
+        if (pthread_create(&wall->threads[i], NULL, wall_worker_main, &wall->workers[i]) != 0) {
+            max7219_wall_deinit(wall);
+            return ESP_ERR_NO_MEM;
+        }
+        wall->config.num_workers = i + 1;
+    }
+
+    return ESP_OK;
+}
+
+void max7219_wall_deinit(max7219_wall_t *wall)
+{
+    if (wall->config.num_workers > 1) {
+        pthread_mutex_lock(&wall->lock);
+        wall->stop = true;
+        pthread_cond_broadcast(&wall->start_cond);
+        pthread_mutex_unlock(&wall->lock);
+        for (int i = 1; i < wall->config.num_workers; i++) {
+            pthread_join(wall->threads[i], NULL);
+        }
+        wall->config.num_workers = 1;
+    }
+
+    pthread_mutex_destroy(&wall->lock);
+    pthread_cond_destroy(&wall->start_cond);
+    pthread_cond_destroy(&wall->done_cond);
+
+    free(wall->canvas);
+    free(wall->tx);
+    free(wall->line_len);
+    wall->canvas = NULL;
+    wall->tx = NULL;
+    wall->line_len = NULL;
+}
+
+void max7219_wall_draw(max7219_wall_t *wall, const char *const *lines, int x)
+{
+    int num_chains = wall->config.num_chains;
+
+    wall->lines = lines;
+    wall->x = x;
+    for (int chain = 0; chain < num_chains; chain++) {
+        wall->line_len[chain] = lines[chain] ? strlen(lines[chain]) : 0;
+    }
+
+    // Release the workers, do our own share, then wait at the frame barrier
+    pthread_mutex_lock(&wall->lock);
+    wall->pending = wall->config.num_workers - 1;
+    wall->generation++;
+    pthread_cond_broadcast(&wall->start_cond);
+    pthread_mutex_unlock(&wall->lock);
+
+    wall_do_tiles(wall, 0);
+
+    pthread_mutex_lock(&wall->lock);
+    while (wall->pending > 0) {
+        pthread_cond_wait(&wall->done_cond, &wall->lock);
+    }
+    pthread_mutex_unlock(&wall->lock);
+
+    if (wall->config.submit) {
+        for (int chain = 0; chain < num_chains; chain++) {
+            wall->config.submit(wall->config.submit_ctx, chain,
+                                &wall->tx[chain * 8 * wall->frame_len], wall->frame_len);
+        }
+    }
+}
+
+#ifdef ESP_PLATFORM
+
+// Same register write to every module of one chain
+static esp_err_t wall_spi_send_all(spi_device_handle_t device, uint8_t *frame, int modules,
+                                   uint8_t reg, uint8_t data)
+{
+    for (int m = 0; m < modules; m++) {
+        frame[m * 2] = reg;
+        frame[m * 2 + 1] = data;
+    }
+    spi_transaction_t trans = {
+        .length = modules * 16,  // bits
+        .tx_buffer = frame,
+    };
+    return spi_device_transmit(device, &trans);
+}
+
+esp_err_t max7219_wall_spi_init(max7219_wall_spi_t *spi, const max7219_wall_spi_config_t *config)
+{
+    if (config->num_chains <= 0 || config->modules_per_chain <= 0 || !config->pin_cs) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(spi, 0, sizeof(*spi));
+    spi->spi_host = config->spi_host;
+    size_t frame_len = config->modules_per_chain * 2;
+    esp_err_t ret = ESP_OK;
+
+    if (config->init_bus) {
+        spi_bus_config_t bus_cfg = {
+            .mosi_io_num = config->pin_mosi,
+            .miso_io_num = -1,  // Not used - MAX7219 is write-only
+            .sclk_io_num = config->pin_clk,
+            .quadwp_io_num = -1,
+            .quadhd_io_num = -1,
+            .max_transfer_sz = frame_len,
+        };
+        ret = spi_bus_initialize(config->spi_host, &bus_cfg, SPI_DMA_CH_AUTO);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to initialize SPI bus: %s", esp_err_to_name(ret));
+            return ret;
+        }
+        spi->own_bus = true;
+    }
+
+    spi->devices = calloc(config->num_chains, sizeof(spi_device_handle_t));
+    uint8_t *frame = malloc(frame_len);
+    if (!spi->devices || !frame) {
+        free(frame);
+        max7219_wall_spi_deinit(spi);
+        return ESP_ERR_NO_MEM;
+    }
+
+    uint8_t intensity = config->intensity > 15 ? 15 : config->intensity;
+    for (int chain = 0; chain < config->num_chains; chain++) {
+        spi_device_interface_config_t dev_cfg = {
+            .clock_speed_hz = config->clock_speed_hz,
+            .mode = 0,  // CPOL=0, CPHA=0
+            .spics_io_num = config->pin_cs[chain],
+            .queue_size = 8,  // One frame per digit row
+        };
+        ret = spi_bus_add_device(config->spi_host, &dev_cfg, &spi->devices[chain]);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to add chain %d: %s", chain, esp_err_to_name(ret));
+            break;
+        }
+        spi->num_chains = chain + 1;
+
+        // Same setup as max7219_init()
+        spi_device_handle_t device = spi->devices[chain];
+        int modules = config->modules_per_chain;
+        ret = wall_spi_send_all(device, frame, modules, WALL_REG_DISPLAYTEST, 0x00);
+        if (ret == ESP_OK) ret = wall_spi_send_all(device, frame, modules, WALL_REG_SCANLIMIT, 0x07);
+        if (ret == ESP_OK) ret = wall_spi_send_all(device, frame, modules, WALL_REG_DECODE, 0x00);
+        if (ret == ESP_OK) ret = wall_spi_send_all(device, frame, modules, WALL_REG_INTENSITY, intensity);
+        if (ret == ESP_OK) ret = wall_spi_send_all(device, frame, modules, WALL_REG_SHUTDOWN, 0x01);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to initialize chain %d: %s", chain, esp_err_to_name(ret));
+            break;
+        }
+    }
+    free(frame);
+
+    if (ret != ESP_OK) {
+        max7219_wall_spi_deinit(spi);
+        return ret;
+    }
+
+    ESP_LOGI(TAG, "Wall SPI initialized: %d chains of %d modules",
+             config->num_chains, config->modules_per_chain);
+    return ESP_OK;
+}
+
+void max7219_wall_spi_deinit(max7219_wall_spi_t *spi)
+{
+    for (int chain = 0; chain < spi->num_chains; chain++) {
+        spi_bus_remove_device(spi->devices[chain]);
+    }
+    free(spi->devices);
+    spi->devices = NULL;
+    spi->num_chains = 0;
+
+    if (spi->own_bus) {
+        spi_bus_free(spi->spi_host);
+        spi->own_bus = false;
+    }
+}
+
+void max7219_wall_spi_submit(void *ctx, int chain, const uint8_t *tx, size_t frame_len)
+{
+    max7219_wall_spi_t *spi = (max7219_wall_spi_t *)ctx;
+    if (chain >= spi->num_chains) return;
+
+    spi_device_handle_t device = spi->devices[chain];
+    int queued = 0;
+
+    // Queue all 8 rows so the frames go out without task gaps
+    for (int row = 0; row < 8; row++) {
+        spi->trans[row] = (spi_transaction_t){
+            .length = frame_len * 8,  // bits
+            .tx_buffer = &tx[row * frame_len],
+        };
+        esp_err_t ret = spi_device_queue_trans(device, &spi->trans[row], portMAX_DELAY);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to queue chain %d row %d: %s", chain, row, esp_err_to_name(ret));
+            break;
+        }
+        queued++;
+    }
+
+    // tx must stay untouched until the driver is done with it
+    for (int row = 0; row < queued; row++) {
+        spi_transaction_t *done;
+        spi_device_get_trans_result(device, &done, portMAX_DELAY);
+    }
+}
+
+#endif // ESP_PLATFORM
@@ -0,0 +1,130 @@
+#ifndef MAX7219_WALL_H
+#define MAX7219_WALL_H
+
+// Video-wall mode for large installations.
+//
+// The wall is a grid of 8x8 modules. Each row of modules is one SPI chain
+// and shows one line of text. The canvas is split into tiles of a few
+// modules; a pool of pthreads renders and row-packs tiles in parallel into
+// per-chain transmit buffers. After a frame barrier every chain buffer is
+// handed to a submit callback; max7219_wall_spi_submit() sends it on an SPI
+// bus set up by max7219_wall_spi_init().
+//
+// The renderer uses only pthreads and the shared font, so it builds on a host
+// as well (see tools/max7219_wall_bench.c).
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <pthread.h>
+
+#ifdef ESP_PLATFORM
+#include "esp_err.h"
+#include "driver/spi_master.h"
+#include "driver/gpio.h"
+#else
+typedef int esp_err_t;
+#define ESP_OK              0
+#define ESP_ERR_NO_MEM      0x101
+#define ESP_ERR_INVALID_ARG 0x102
+#endif
+
+#define MAX7219_WALL_MAX_WORKERS    16
+
+// Called once per chain after the frame barrier. tx holds 8 CS frames (one
+// per digit row) of frame_len bytes each, laid out like max7219_send_row().
+typedef void (*max7219_wall_submit_fn)(void *ctx, int chain, const uint8_t *tx, size_t frame_len);
+
+typedef struct {
+    int num_chains;             // Module rows (one SPI chain each)
+    int modules_per_chain;      // Modules in each chain
+    int tile_modules;           // Modules per work unit
+    int num_workers;            // Render threads, including the caller
+    max7219_wall_submit_fn submit;  // May be NULL (render only)
+    void *submit_ctx;
+} max7219_wall_config_t;
+
+typedef struct max7219_wall max7219_wall_t;
+
+// Per-thread context for the worker pool
+typedef struct {
+    max7219_wall_t *wall;
+    int index;
+} max7219_wall_worker_t;
+
+struct max7219_wall {
+    max7219_wall_config_t config;
+    int width;                  // Canvas width in columns
+    int tiles_per_chain;
+    int num_tiles;
+    size_t frame_len;           // Bytes per CS frame (2 per module)
+
+    uint8_t *canvas;            // num_chains * width column bytes
+    uint8_t *tx;                // num_chains * 8 * frame_len
+
+    // Current frame job, read by workers between the start and end barrier
+    const char *const *lines;
+    uint16_t *line_len;
+    int x;
+
+    // Worker pool; worker 0 is the thread calling max7219_wall_draw()
+    pthread_t threads[MAX7219_WALL_MAX_WORKERS];
+    max7219_wall_worker_t workers[MAX7219_WALL_MAX_WORKERS];
+    pthread_mutex_t lock;
+    pthread_cond_t start_cond;
+    pthread_cond_t done_cond;
+    unsigned generation;
+    int pending;
+    bool stop;
+};
+
+// Allocate buffers and start the worker threads
+esp_err_t max7219_wall_init(max7219_wall_t *wall, const max7219_wall_config_t *config);
+
+// Stop the workers and free all buffers
+void max7219_wall_deinit(max7219_wall_t *wall);
+
+// Render one frame: lines[chain] at column x (NULL = blank chain), pack all
+// chains in parallel, then submit every chain
+void max7219_wall_draw(max7219_wall_t *wall, const char *const *lines, int x);
+
+#ifdef ESP_PLATFORM
+
+// SPI output for a wall. All chains share MOSI and CLK, each has its own CS
+// line, so the chain count is limited by the CS lines of the host (6 on
+// SPI2 of the ESP32-C6). A frame is modules_per_chain * 2 bytes, far more
+// than max7219_init() sets up its bus for, so the wall needs a bus with
+// DMA and max_transfer_sz of at least one frame.
+typedef struct {
+    spi_host_device_t spi_host;
+    gpio_num_t pin_mosi;        // Ignored unless init_bus is set
+    gpio_num_t pin_clk;
+    const gpio_num_t *pin_cs;   // One per chain
+    int num_chains;
+    int modules_per_chain;
+    int clock_speed_hz;         // Max 10MHz
+    uint8_t intensity;          // 0-15
+    bool init_bus;              // False if the caller has set up the bus as above
+} max7219_wall_spi_config_t;
+
+typedef struct {
+    spi_host_device_t spi_host;
+    bool own_bus;
+    int num_chains;
+    spi_device_handle_t *devices;   // One per chain
+    spi_transaction_t trans[8];
+} max7219_wall_spi_t;
+
+// Set up the bus and chain devices and initialize every chip
+esp_err_t max7219_wall_spi_init(max7219_wall_spi_t *spi, const max7219_wall_spi_config_t *config);
+
+// Remove the devices (and free the bus if max7219_wall_spi_init() set it up)
+void max7219_wall_spi_deinit(max7219_wall_spi_t *spi);
+
+// Submit callback for max7219_wall_config_t, with a max7219_wall_spi_t as
+// ctx. Sends a chain's 8 frames back to back and waits for them.
+void max7219_wall_spi_submit(void *ctx, int chain, const uint8_t *tx, size_t frame_len);
+
+#endif // ESP_PLATFORM
+
+#endif // MAX7219_WALL_H
@@ -0,0 +1,314 @@
+// Host-side decoder for MAX7219 bus traces (see main/max7219_trace.h).
+//
+// Replays a trace through a model of the chip chain and prints every
+// displayed frame as ASCII art, or writes PBM images, together with the SPI
+// bus utilisation (at the SPI clock in effect for each write) and PWM duty
+// for that frame. Frames are the chain state at the start of the trace
+// (STATE record), at every MARK record, and at the end of the trace if
+// writes follow the last MARK.
+//
+// Build:  cc -O2 -Imain -o max7219_trace_decode tools/max7219_trace_decode.c
+// Usage:  max7219_trace_decode [-p prefix] [-q] trace-file
+//
+// The input is either a binary snapshot from max7219_trace_snapshot() or a
+// console log containing the "M7TR:" hex lines from max7219_trace_print().
+// A log with several dumps has each one decoded in turn.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "max7219_trace.h"
+
+#define MAX_CHIPS   255
+#define MAX_DUMPS   64
+
+// MAX7219 register addresses (mirrors main/max7219.h, which needs ESP-IDF)
+#define REG_DIGIT0      0x01
+#define REG_DIGIT7      0x08
+#define REG_DECODE      0x09
+#define REG_INTENSITY   0x0A
+#define REG_SCANLIMIT   0x0B
+#define REG_SHUTDOWN    0x0C
+#define REG_DISPLAYTEST 0x0F
+
+typedef struct {
+    uint8_t digit[8];
+    uint8_t decode;
+    uint8_t intensity;
+    uint8_t scanlimit;
+    uint8_t shutdown;   // 1 = normal operation (PWM gating is reported as duty)
+    uint8_t test;
+} chip_model_t;
+
+static chip_model_t chips[MAX_CHIPS];
+static int num_chips;
+static uint32_t clock_hz;
+
+static const char *pbm_prefix = NULL;
+static int quiet = 0;
+static int dump_index = -1;     // Set when a log holds several dumps
+
+static void chip_write(int chip, uint8_t reg, uint8_t data)
+{
+    chip_model_t *c = &chips[chip];
+    if (reg >= REG_DIGIT0 && reg <= REG_DIGIT7) c->digit[reg - REG_DIGIT0] = data;
+    else if (reg == REG_DECODE) c->decode = data;
+    else if (reg == REG_INTENSITY) c->intensity = data & 0x0F;
+    else if (reg == REG_SCANLIMIT) c->scanlimit = data & 0x07;
+    else if (reg == REG_SHUTDOWN) c->shutdown = data & 0x01;
+    else if (reg == REG_DISPLAYTEST) c->test = data & 0x01;
+}
+
+// Pixel as the chain would show it, in framebuffer coordinates
+static int pixel(int x, int y)
+{
+    const chip_model_t *c = &chips[x / 8];
+    if (c->test) return 1;
+    if (!c->shutdown || y > c->scanlimit) return 0;
+    return (c->digit[y] >> (7 - (x % 8))) & 1;
+}
+
+// partial: some of the frame's writes fell off the ring, so the bus figures
+// only cover part of the interval
+static void emit_frame(int index, const char *what, uint32_t t_us, uint32_t interval_us,
+                       uint32_t spi_bytes, double busy_us, int partial,
+                       uint32_t pwm_edges, uint32_t pwm_on_us)
+{
+    double util = interval_us ? 100.0 * busy_us / interval_us : 0.0;
+    double duty = interval_us ? 100.0 * pwm_on_us / interval_us : 0.0;
+
+    printf("frame %d (%s)  t=%u us  interval=%u us", index, what, t_us, interval_us);
+    if (partial) printf("  spi>=%u bytes  busy>=%.1f us  util=n/a", spi_bytes, busy_us);
+    else printf("  spi=%u bytes  busy=%.1f us  util=%.2f%%", spi_bytes, busy_us, util);
+    if (pwm_edges) printf("  pwm_edges=%u  pwm_on=%.0f%%", pwm_edges, duty);
+    printf("  clock=%.2f MHz  intensity=%u\n", clock_hz / 1e6, chips[0].intensity);
+
+    int width = num_chips * 8;
+    if (!quiet) {
+        for (int y = 0; y < 8; y++) {
+            for (int x = 0; x < width; x++) putchar(pixel(x, y) ? '#' : '.');
+            putchar('\n');
+        }
+    }
+
+    if (pbm_prefix) {
+        char path[512];
+        if (dump_index >= 0) snprintf(path, sizeof(path), "%s%02d_%05d.pbm", pbm_prefix, dump_index, index);
+        else snprintf(path, sizeof(path), "%s%05d.pbm", pbm_prefix, index);
+        FILE *f = fopen(path, "w");
+        if (!f) {
+            perror(path);
+            return;
+        }
+        fprintf(f, "P1\n%d 8\n", width);
+        for (int y = 0; y < 8; y++) {
+            for (int x = 0; x < width; x++) fputs(pixel(x, y) ? "1 " : "0 ", f);
+            fputc('\n', f);
+        }
+        fclose(f);
+    }
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static double bus_time_us(uint32_t bytes)
+{
+    return clock_hz ? (double)bytes * 8 * 1e6 / clock_hz : 0.0;
+}
+
+static int replay(const uint8_t *buf, size_t len)
+{
+    if (len < MAX7219_TRACE_HEADER_SIZE || memcmp(buf, MAX7219_TRACE_MAGIC, 4) != 0) {
+        fprintf(stderr, "not a MAX7219 trace\n");
+        return 1;
+    }
+    if (buf[4] != MAX7219_TRACE_VERSION) {
+        fprintf(stderr, "unsupported trace version %u\n", buf[4]);
+        return 1;
+    }
+    num_chips = buf[5];
+    clock_hz = get_u32(&buf[8]);
+    if (num_chips == 0) {
+        fprintf(stderr, "trace has no chips\n");
+        return 1;
+    }
+
+    for (int i = 0; i < num_chips; i++) memset(&chips[i], 0, sizeof(chips[i]));
+
+    size_t pos = MAX7219_TRACE_HEADER_SIZE;
+    int frame = 0;
+    int have_start = 0;
+    uint32_t start_us = 0, last_us = 0;
+    uint32_t base_us = 0;
+    uint32_t spi_bytes = 0;
+    double busy_us = 0.0;   // Bus time at the clock each write went out at
+
+    while (pos < len) {
+        uint8_t kind = buf[pos];
+        size_t rec_len = max7219_trace_record_len(kind, num_chips);
+        if (rec_len == 0 || pos + rec_len > len) {
+            fprintf(stderr, "corrupt record at offset %zu\n", pos);
+            return 1;
+        }
+        uint32_t t_us = get_u32(&buf[pos + 1]);
+        const uint8_t *p = &buf[pos + MAX7219_TRACE_REC_HEADER];
+        if (!have_start) {
+            start_us = t_us;
+            have_start = 1;
+        }
+
+        switch (kind) {
+            case MAX7219_TRACE_ALL:
+                for (int i = 0; i < num_chips; i++) chip_write(i, p[0], p[1]);
+                spi_bytes += num_chips * 2;
+                busy_us += bus_time_us(num_chips * 2);
+                break;
+            case MAX7219_TRACE_ROW:
+                for (int i = 0; i < num_chips; i++) chip_write(i, p[0], p[1 + i]);
+                spi_bytes += num_chips * 2;
+                busy_us += bus_time_us(num_chips * 2);
+                break;
+            case MAX7219_TRACE_FRAME:
+                for (int i = 0; i < num_chips; i++) chip_write(i, p[i * 2], p[i * 2 + 1]);
+                spi_bytes += num_chips * 2;
+                busy_us += bus_time_us(num_chips * 2);
+                break;
+            case MAX7219_TRACE_STATE:
+                // Chain state before the oldest record still in the ring
+                clock_hz = get_u32(&p[0]);
+                for (int i = 0; i < num_chips; i++) {
+                    for (int reg = 1; reg < 16; reg++) chip_write(i, reg, p[4 + i * 16 + reg]);
+                }
+                emit_frame(frame++, "state", t_us, 0, 0, 0.0, 0, 0, 0);
+                spi_bytes = 0;
+                busy_us = 0.0;
+                base_us = t_us;     // Time of the newest write folded into the state
+                have_start = 0;
+                break;
+            case MAX7219_TRACE_MARK: {
+                // The frame started at the previous MARK, which may have been
+                // dropped along with some of this frame's writes
+                uint32_t frame_start_us = get_u32(&p[8]);
+                emit_frame(frame++, "mark", t_us, t_us - frame_start_us, spi_bytes, busy_us,
+                           (int32_t)(base_us - frame_start_us) > 0,
+                           get_u32(&p[0]), get_u32(&p[4]));
+                start_us = t_us;
+                spi_bytes = 0;
+                busy_us = 0.0;
+                break;
+            }
+            case MAX7219_TRACE_CLOCK:
+                clock_hz = get_u32(&p[0]);
+                break;
+        }
+        last_us = t_us;
+        pos += rec_len;
+    }
+
+    // Writes after the last MARK are on the chips too
+    if (spi_bytes) {
+        emit_frame(frame++, "end", last_us, last_us - start_us, spi_bytes, busy_us, 0, 0, 0);
+    }
+
+    printf("%d frames, %zu bytes of records, last record at t=%u us\n",
+           frame, len - MAX7219_TRACE_HEADER_SIZE, last_us);
+    return 0;
+}
+
+// Collect the hex payload of every "M7TR:" line. A line that starts with the
+// magic begins a new dump; its offset in out is stored in starts.
+static size_t parse_hex_log(const char *text, size_t text_len, uint8_t *out,
+                            size_t *starts, int *num_dumps)
+{
+    static const char magic_hex[] = "4d375452";   // MAX7219_TRACE_MAGIC
+    size_t n = 0;
+    *num_dumps = 0;
+    const char *end = text + text_len;
+    const char *line = text;
+
+    while (line < end) {
+        const char *eol = memchr(line, '\n', end - line);
+        if (!eol) eol = end;
+        const char *tag = line;
+        while (tag + 5 <= eol && memcmp(tag, "M7TR:", 5) != 0) tag++;
+        if (tag + 5 <= eol) {
+            const char *hex = tag + 5;
+            if (eol - hex >= 8 && strncmp(hex, magic_hex, 8) == 0 && *num_dumps < MAX_DUMPS) {
+                starts[(*num_dumps)++] = n;
+            }
+            for (const char *h = hex; h + 1 < eol && isxdigit((unsigned char)h[0]) &&
+                                          isxdigit((unsigned char)h[1]); h += 2) {
+                char byte[3] = {h[0], h[1], 0};
+                out[n++] = (uint8_t)strtoul(byte, NULL, 16);
+            }
+        }
+        line = eol + 1;
+    }
+    return n;
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) pbm_prefix = argv[++i];
+        else if (strcmp(argv[i], "-q") == 0) quiet = 1;
+        else path = argv[i];
+    }
+    if (!path) {
+        fprintf(stderr, "usage: %s [-p pbm-prefix] [-q] trace-file\n", argv[0]);
+        return 2;
+    }
+
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return 1;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *data = malloc(size > 0 ? size : 1);
+    if (!data || fread(data, 1, size, f) != (size_t)size) {
+        fprintf(stderr, "failed to read %s\n", path);
+        fclose(f);
+        return 1;
+    }
+    fclose(f);
+
+    // Binary snapshots carry the version byte where the log has ':'
+    int ret;
+    if (size > 4 && memcmp(data, MAX7219_TRACE_MAGIC, 4) == 0 && data[4] != ':') {
+        ret = replay(data, size);
+    } else {
+        uint8_t *bin = malloc(size / 2 + 1);
+        if (!bin) {
+            fprintf(stderr, "out of memory\n");
+            free(data);
+            return 1;
+        }
+        size_t starts[MAX_DUMPS];
+        int num_dumps;
+        size_t n = parse_hex_log((const char *)data, size, bin, starts, &num_dumps);
+        if (num_dumps == 0) {
+            ret = replay(bin, n);   // Reports the missing header
+        } else {
+            ret = 0;
+            for (int i = 0; i < num_dumps; i++) {
+                size_t end = (i + 1 < num_dumps) ? starts[i + 1] : n;
+                if (num_dumps > 1) {
+                    printf("dump %d\n", i);
+                    dump_index = i;
+                }
+                if (replay(bin + starts[i], end - starts[i]) != 0) ret = 1;
+            }
+        }
+        free(bin);
+    }
+    free(data);
+    return ret;
+}
@@ -0,0 +1,75 @@
+// Host benchmark for the video-wall renderer (see main/max7219_wall.h).
+//
+// Scrolls a message across walls of 64 to 1024 modules with 1 to N worker
+// threads and reports the render + pack time per frame and the speedup over
+// a single worker. Submission is not included (no SPI on the host).
+//
+// Build:  cc -O2 -pthread -Imain -o max7219_wall_bench
+//             tools/max7219_wall_bench.c main/max7219_wall.c main/max7219_font.c
+// Usage:  max7219_wall_bench [max-workers] [frames]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "max7219_wall.h"
+
+#define WALL_CHAINS     8       // Module rows; chain length grows with wall size
+
+static const char *MESSAGE =
+    "Hello from the video wall! The quick brown fox jumps over the lazy dog 0123456789   ";
+
+static double now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static double run(int modules, int workers, int frames)
+{
+    max7219_wall_config_t config = {
+        .num_chains = WALL_CHAINS,
+        .modules_per_chain = modules / WALL_CHAINS,
+        .tile_modules = 4,
+        .num_workers = workers,
+    };
+    max7219_wall_t wall;
+    if (max7219_wall_init(&wall, &config) != ESP_OK) {
+        fprintf(stderr, "wall init failed (%d modules, %d workers)\n", modules, workers);
+        exit(1);
+    }
+
+    const char *lines[WALL_CHAINS];
+    for (int i = 0; i < WALL_CHAINS; i++) lines[i] = MESSAGE;
+
+    // One warm-up frame so thread start-up is not measured
+    max7219_wall_draw(&wall, lines, 0);
+
+    double start = now_us();
+    for (int f = 0; f < frames; f++) {
+        max7219_wall_draw(&wall, lines, wall.width - f);
+    }
+    double per_frame = (now_us() - start) / frames;
+
+    max7219_wall_deinit(&wall);
+    return per_frame;
+}
+
+int main(int argc, char **argv)
+{
+    int max_workers = argc > 1 ? atoi(argv[1]) : 8;
+    int frames = argc > 2 ? atoi(argv[2]) : 500;
+    if (max_workers < 1) max_workers = 1;
+    if (max_workers > MAX7219_WALL_MAX_WORKERS) max_workers = MAX7219_WALL_MAX_WORKERS;
+
+    printf("%8s %8s %12s %8s\n", "modules", "workers", "us/frame", "speedup");
+    for (int modules = 64; modules <= 1024; modules *= 2) {
+        double base = 0;
+        for (int workers = 1; workers <= max_workers; workers *= 2) {
+            double t = run(modules, workers, frames);
+            if (workers == 1) base = t;
+            printf("%8d %8d %12.1f %8.2f\n", modules, workers, t, base / t);
+        }
+    }
+    return 0;
+}